@@ -0,0 +1,202 @@
+#include "ndn-ledger.hpp"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+namespace ndn {
+
+LedgerRecord::LedgerRecord(shared_ptr<const Data> contentObject,
+                           int weight, int entropy, bool isArchived)
+  : block(contentObject)
+  , weight(weight)
+  , entropy(entropy)
+  , isArchived(isArchived)
+{
+}
+
+static int
+FromHexChar(uint8_t c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+bool
+Ledger::GetDigest(const Name& recordName, RecordDigest& digest)
+{
+  if (recordName.empty()) {
+    return false;
+  }
+
+  const auto& component = recordName.get(-1);
+  if (component.value_size() != digest.size() * 2) {
+    return false;
+  }
+
+  const uint8_t* hex = component.value();
+  for (size_t i = 0; i != digest.size(); i++) {
+    int hi = FromHexChar(hex[2 * i]);
+    int lo = FromHexChar(hex[2 * i + 1]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    digest[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+bool
+ApproverSet::Insert(uint32_t ordinal)
+{
+  if (ordinal < INLINE_ORDINALS) {
+    if (m_inline.test(ordinal)) {
+      return false;
+    }
+    m_inline.set(ordinal);
+  }
+  else if (!m_overflow.insert(ordinal).second) {
+    return false;
+  }
+  m_size++;
+  return true;
+}
+
+bool
+ApproverSet::Contains(uint32_t ordinal) const
+{
+  if (ordinal < INLINE_ORDINALS) {
+    return m_inline.test(ordinal);
+  }
+  return m_overflow.count(ordinal) > 0;
+}
+
+std::vector<uint32_t>
+ApproverSet::GetOrdinals() const
+{
+  std::vector<uint32_t> ordinals;
+  ordinals.reserve(m_size);
+  for (uint32_t i = 0; i != INLINE_ORDINALS; i++) {
+    if (m_inline.test(i)) {
+      ordinals.push_back(i);
+    }
+  }
+  ordinals.insert(ordinals.end(), m_overflow.begin(), m_overflow.end());
+  return ordinals;
+}
+
+RecordId
+Ledger::find(const Name& recordName) const
+{
+  RecordDigest digest;
+  if (!GetDigest(recordName, digest)) {
+    return INVALID_RECORD_ID;
+  }
+  return find(digest);
+}
+
+RecordId
+Ledger::find(const RecordDigest& digest) const
+{
+  auto it = m_index.find(digest);
+  if (it == m_index.end()) {
+    return INVALID_RECORD_ID;
+  }
+  return it->second;
+}
+
+RecordId
+Ledger::insert(LedgerRecord record)
+{
+  RecordDigest digest;
+  if (!GetDigest(record.block->getName(), digest)) {
+    return INVALID_RECORD_ID;
+  }
+  return insert(std::move(record), digest);
+}
+
+RecordId
+Ledger::insert(LedgerRecord record, const RecordDigest& digest)
+{
+  RecordId id = static_cast<RecordId>(m_records.size());
+  auto result = m_index.insert(std::make_pair(digest, id));
+  if (!result.second) {
+    return result.first->second;
+  }
+
+  m_records.push_back(std::move(record));
+  m_records.back().digest = digest;
+  return id;
+}
+
+void
+TipSet::Place(RecordId id, uint8_t pool)
+{
+  if (id >= m_slots.size()) {
+    m_slots.resize(id + 1);
+  }
+  m_slots[id].pool = pool;
+  m_slots[id].position = m_pools[pool].size();
+  m_pools[pool].push_back(id);
+}
+
+void
+TipSet::Insert(RecordId id, bool eligible)
+{
+  if (Contains(id)) {
+    return;
+  }
+  Place(id, eligible ? ELIGIBLE : INELIGIBLE);
+}
+
+void
+TipSet::Erase(RecordId id)
+{
+  if (!Contains(id)) {
+    return;
+  }
+
+  // move the last tip of the pool into the freed position
+  auto& slot = m_slots[id];
+  auto& pool = m_pools[slot.pool];
+  RecordId last = pool.back();
+  pool[slot.position] = last;
+  m_slots[last].position = slot.position;
+  pool.pop_back();
+  slot.pool = NO_POOL;
+}
+
+void
+TipSet::SetEligible(RecordId id, bool eligible)
+{
+  uint8_t pool = eligible ? ELIGIBLE : INELIGIBLE;
+  if (!Contains(id) || m_slots[id].pool == pool) {
+    return;
+  }
+  Erase(id);
+  Place(id, pool);
+}
+
+std::vector<RecordId>
+TipSet::SampleEligible(size_t count, Ptr<UniformRandomVariable> random)
+{
+  // partial Fisher-Yates: the first i positions hold the tips sampled so far
+  auto& pool = m_pools[ELIGIBLE];
+  count = std::min(count, pool.size());
+  std::vector<RecordId> sampled;
+  sampled.reserve(count);
+  for (size_t i = 0; i != count; i++) {
+    size_t j = random->GetInteger(i, pool.size() - 1);
+    std::swap(pool[i], pool[j]);
+    m_slots[pool[i]].position = i;
+    m_slots[pool[j]].position = j;
+    sampled.push_back(pool[i]);
+  }
+  return sampled;
+}
+
+}
+}
@@ -0,0 +1,265 @@
+#ifndef NDN_LEDGER_H
+#define NDN_LEDGER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/random-variable-stream.h"
+
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+// Dense index of a record inside the ledger arena
+typedef uint32_t RecordId;
+
+const RecordId INVALID_RECORD_ID = std::numeric_limits<RecordId>::max();
+
+// SHA-256 digest carried as the last component of every record name (/mc-prefix/producer/digest)
+typedef std::array<uint8_t, 32> RecordDigest;
+
+struct RecordDigestHash
+{
+  size_t
+  operator()(const RecordDigest& digest) const
+  {
+    // digests are uniformly distributed, so any 8 bytes make a good hash
+    size_t hash;
+    std::memcpy(&hash, digest.data(), sizeof(hash));
+    return hash;
+  }
+};
+
+// Hashes the value of a name component, e.g. to keep producer components in a hashed set
+struct NameComponentHash
+{
+  size_t
+  operator()(const name::Component& component) const
+  {
+    // FNV-1a over the component value
+    size_t hash = 14695981039346656037ULL;
+    for (auto it = component.value_begin(); it != component.value_end(); ++it) {
+      hash = (hash ^ *it) * 1099511628211ULL;
+    }
+    return hash;
+  }
+};
+
+// Approval edge parsed from record content once, when the record arrives.
+// The approved record is named /mc-prefix/producer/digest.
+struct ApprovalEdge
+{
+  RecordDigest digest;
+  name::Component producer;
+};
+
+// Set of producers approving a record, by the ordinal the peer assigned to each producer.
+// The first INLINE_ORDINALS producers live in a fixed-width bitset; later ones fall back
+// to a hash set that is only allocated in networks with more peers.
+class ApproverSet
+{
+public:
+  static const uint32_t INLINE_ORDINALS = 64;
+
+  // Returns false if the producer was already in the set
+  bool
+  Insert(uint32_t ordinal);
+
+  bool
+  Contains(uint32_t ordinal) const;
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  // Ordinals in the set, the inline ones in increasing order
+  std::vector<uint32_t>
+  GetOrdinals() const;
+
+private:
+  std::bitset<INLINE_ORDINALS> m_inline;
+  std::unordered_set<uint32_t> m_overflow;
+  uint32_t m_size = 0;
+};
+
+class LedgerRecord
+{
+public:
+  LedgerRecord(shared_ptr<const Data> contentObject,
+               int weight = 1, int entropy = 0, bool isArchived = false);
+public:
+  // Null once the peer pruned the record; the digest and the producer still name it
+  shared_ptr<const Data> block;
+  RecordDigest digest{}; // set by Ledger::insert
+  uint32_t producer = 0; // the peer's ordinal of the producer
+  int weight = 1;
+  int entropy = 0;
+  ApproverSet approvers;
+  bool isArchived = false;
+  bool isCheckpoint = false;
+  // Approves records the peer never had: the checkpoint it bootstrapped from, or the suffix
+  // records caught up after it
+  bool hasHistoryGap = false;
+
+  // Approvals parsed from the content; only kept while the record is pending
+  std::vector<ApprovalEdge> approvedBlocks;
+
+  // IDs of the records directly approved by this one, resolved when the record is admitted
+  std::vector<RecordId> approvals;
+
+  // Peer's propagation epoch in which this record was last visited
+  uint32_t visitEpoch = 0;
+
+  // Links of the peer's unconfirmed list, in admission order
+  Time admissionTime;
+  RecordId prevUnconfirmed = INVALID_RECORD_ID;
+  RecordId nextUnconfirmed = INVALID_RECORD_ID;
+};
+
+// Arena of ledger records addressed by interned RecordId.
+// Records are only ever appended, so an ID stays valid for the lifetime of the ledger.
+// References returned by operator[] are invalidated by insert().
+class Ledger
+{
+public:
+  typedef std::vector<LedgerRecord>::const_iterator const_iterator;
+
+  // Extracts the digest from the last component of a record name.
+  // Returns false if the component is not a hex-encoded SHA-256 digest.
+  static bool
+  GetDigest(const Name& recordName, RecordDigest& digest);
+
+  // Returns the ID of the record, or INVALID_RECORD_ID if it is not in the ledger
+  RecordId
+  find(const Name& recordName) const;
+
+  RecordId
+  find(const RecordDigest& digest) const;
+
+  // Interns the record and returns its ID.
+  // If a record with the same digest exists, its ID is returned and the ledger is unchanged.
+  RecordId
+  insert(LedgerRecord record);
+
+  // Same as above, with the digest already extracted from the record name
+  RecordId
+  insert(LedgerRecord record, const RecordDigest& digest);
+
+  LedgerRecord&
+  operator[](RecordId id)
+  {
+    return m_records[id];
+  }
+
+  const LedgerRecord&
+  operator[](RecordId id) const
+  {
+    return m_records[id];
+  }
+
+  size_t
+  size() const
+  {
+    return m_records.size();
+  }
+
+  const_iterator
+  begin() const
+  {
+    return m_records.begin();
+  }
+
+  const_iterator
+  end() const
+  {
+    return m_records.end();
+  }
+
+private:
+  std::vector<LedgerRecord> m_records;
+  std::unordered_map<RecordDigest, RecordId, RecordDigestHash> m_index;
+};
+
+// Set of tip records split into a pool that may be approved and a pool that may not
+// (own or archived records). Each pool is a dense vector, and the slot of every tip is
+// indexed by RecordId, so insert, erase, pool change and uniform sampling are O(1).
+class TipSet
+{
+public:
+  void
+  Insert(RecordId id, bool eligible);
+
+  void
+  Erase(RecordId id);
+
+  // Moves a tip to the other pool; does nothing if id is not a tip
+  void
+  SetEligible(RecordId id, bool eligible);
+
+  bool
+  Contains(RecordId id) const
+  {
+    return id < m_slots.size() && m_slots[id].pool != NO_POOL;
+  }
+
+  // Samples up to count distinct eligible tips uniformly at random
+  std::vector<RecordId>
+  SampleEligible(size_t count, Ptr<UniformRandomVariable> random);
+
+  size_t
+  size() const
+  {
+    return m_pools[ELIGIBLE].size() + m_pools[INELIGIBLE].size();
+  }
+
+  size_t
+  EligibleSize() const
+  {
+    return m_pools[ELIGIBLE].size();
+  }
+
+  const std::vector<RecordId>&
+  GetEligible() const
+  {
+    return m_pools[ELIGIBLE];
+  }
+
+  const std::vector<RecordId>&
+  GetIneligible() const
+  {
+    return m_pools[INELIGIBLE];
+  }
+
+private:
+  void
+  Place(RecordId id, uint8_t pool);
+
+private:
+  enum : uint8_t {
+    ELIGIBLE = 0,
+    INELIGIBLE = 1,
+    NO_POOL = 2
+  };
+
+  struct Slot
+  {
+    uint8_t pool = NO_POOL;
+    uint32_t position = 0;
+  };
+
+  std::vector<RecordId> m_pools[2];
+  std::vector<Slot> m_slots;
+};
+
+}
+}
+
+#endif
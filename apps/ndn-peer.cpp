@@ -1,4 +1,5 @@
 #include "ndn-peer.hpp"
+#include "ndn-record-content.hpp"
 #include "ns3/random-variable-stream.h"
 #include "ns3/ptr.h"
 #include "ns3/log.h"
@@ -10,13 +11,18 @@
 #include "ns3/uinteger.h"
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/nstime.h"
 
 #include <stdlib.h>
 #include <math.h>
 #include "../ndn-cxx/src/util/sha256.hpp"
 #include "../ndn-cxx/src/encoding/block-helpers.hpp"
 #include "../ndn-cxx/src/encoding/tlv.hpp"
+#include "../ndn-cxx/src/util/string-helper.hpp"
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include "ns3/ndnSIM/utils/ndn-rtt-mean-deviation.hpp"
+
+#include <ndn-cxx/lp/tags.hpp>
 
 NS_LOG_COMPONENT_DEFINE("ndn.peer");
 
@@ -25,22 +31,6 @@ namespace ndn {
 
 NS_OBJECT_ENSURE_REGISTERED(Peer);
 
-LedgerRecord::LedgerRecord(shared_ptr<const Data> contentObject,
-                           int weight, int entropy, bool isArchived)
-  : block(contentObject)
-  , weight(weight)
-  , entropy(entropy)
-  , isArchived(isArchived)
-{
-  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable>();
-  int num = static_cast<int>(x->GetValue()*100);
-  //if (num > 95) {
-  {
-    isASample = true;
-    creationTime = Simulator::Now();
-  }
-}
-
 // register NS-3 Type
 TypeId
 Peer::GetTypeId()
@@ -62,6 +52,60 @@ Peer::GetTypeId()
     .AddAttribute("ReferredNum", "Number of referred blocks", IntegerValue(2),
                   MakeIntegerAccessor(&Peer::m_referredNum), MakeIntegerChecker<int32_t>())
     //********
+    .AddAttribute("MaxSyncTips", "Max number of tips advertised by a sync interest", UintegerValue(32),
+                  MakeUintegerAccessor(&Peer::m_maxSyncTips), MakeUintegerChecker<uint32_t>(1))
+    .AddAttribute("FetchWindow", "Max number of record fetching interests in flight", UintegerValue(16),
+                  MakeUintegerAccessor(&Peer::m_fetchWindow), MakeUintegerChecker<uint32_t>(1))
+    .AddAttribute("MaxFetchRetx", "Retransmissions of a record fetching interest before giving up",
+                  UintegerValue(3),
+                  MakeUintegerAccessor(&Peer::m_maxFetchRetx), MakeUintegerChecker<uint32_t>())
+    .AddAttribute("FetchRetxTimer", "Timeout defining how frequent fetch timeouts should be checked",
+                  TimeValue(MilliSeconds(50)),
+                  MakeTimeAccessor(&Peer::m_fetchRetxTimer), MakeTimeChecker())
+    .AddAttribute("SyncReplyDelay",
+                  "Back-off per hop before replying to a SYNC with stale tips; the reply is dropped "
+                  "if a SYNC with no stale tips is heard meanwhile",
+                  TimeValue(MilliSeconds(10)),
+                  MakeTimeAccessor(&Peer::m_syncReplyDelay), MakeTimeChecker())
+    .AddAttribute("CatchUpThreshold",
+                  "Number of pending records that starts a bulk catch-up from the producer of the "
+                  "last one; 0 disables catch-up",
+                  UintegerValue(16),
+                  MakeUintegerAccessor(&Peer::m_catchUpThreshold), MakeUintegerChecker<uint32_t>())
+    .AddAttribute("CatchUpSegmentSize", "Max bytes of records bundled in a catch-up segment",
+                  UintegerValue(7000),
+                  MakeUintegerAccessor(&Peer::m_catchUpSegmentSize),
+                  MakeUintegerChecker<uint32_t>(1))
+    .AddAttribute("CatchUpCacheLifetime",
+                  "How long a responder keeps the segments of a catch-up after its first interest",
+                  TimeValue(Seconds(10)),
+                  MakeTimeAccessor(&Peer::m_catchUpCacheLifetime), MakeTimeChecker())
+    .AddAttribute("CheckpointInterval",
+                  "Number of records archived between the checkpoint records a peer generates; "
+                  "0 disables checkpoints",
+                  UintegerValue(0),
+                  MakeUintegerAccessor(&Peer::m_checkpointInterval),
+                  MakeUintegerChecker<uint32_t>())
+    .AddAttribute("BootstrapFromCheckpoint",
+                  "Start from the latest archived checkpoint of the neighbors and fetch only the "
+                  "records after it, instead of the whole ledger",
+                  BooleanValue(false),
+                  MakeBooleanAccessor(&Peer::m_bootstrapFromCheckpoint), MakeBooleanChecker())
+    .AddAttribute("PruneDepth",
+                  "Number of records archived after a record before its Data is released; "
+                  "0 keeps the Data of every record",
+                  UintegerValue(0),
+                  MakeUintegerAccessor(&Peer::m_pruneDepth), MakeUintegerChecker<uint32_t>())
+    .AddAttribute("SpillFile",
+                  "Prefix of the file pruned records are written to, to serve later fetches; "
+                  "the node ID is appended.  If empty, pruned records are no longer served",
+                  StringValue(""),
+                  MakeStringAccessor(&Peer::m_spillFilePrefix), MakeStringChecker())
+    .AddAttribute("MaxPushSize",
+                  "Max wire size of a record carried in its NOTIF Interest, so that receivers do not "
+                  "fetch it; 0 disables pushing",
+                  UintegerValue(0),
+                  MakeUintegerAccessor(&Peer::m_maxPushSize), MakeUintegerChecker<uint32_t>())
     .AddAttribute("Routable-Prefix", "Node's Prefix, for which producer has the data", StringValue("/"),
                   MakeNameAccessor(&Peer::m_routablePrefix), MakeNameChecker())
     .AddAttribute("Multicast-Prefix", "Multicast Prefix", StringValue("/dledger"),
@@ -77,51 +121,212 @@ Peer::GetTypeId()
                   "Type of sync randomization: none (default), uniform, exponential",
                   StringValue("none"),
                   MakeStringAccessor(&Peer::SetSyncRandomize, &Peer::GetSyncRandomize),
-                  MakeStringChecker());
+                  MakeStringChecker())
+    .AddAttribute("ConfirmationLatencyBinWidth", "Bin width of the confirmation latency histogram",
+                  TimeValue(Seconds(1.0)),
+                  MakeTimeAccessor(&Peer::m_latencyBinWidth), MakeTimeChecker())
+    .AddAttribute("UnconfirmedCount", "Number of admitted records that are not archived yet",
+                  TypeId::ATTR_GET, UintegerValue(0),
+                  MakeUintegerAccessor(&Peer::GetUnconfirmedCount),
+                  MakeUintegerChecker<uint32_t>())
+    .AddAttribute("OldestUnconfirmedAge", "Time since the oldest unconfirmed record was admitted",
+                  TypeId::ATTR_GET, TimeValue(Seconds(0)),
+                  MakeTimeAccessor(&Peer::GetOldestUnconfirmedAge), MakeTimeChecker())
+    .AddTraceSource("UnconfirmedCount", "Number of admitted records that are not archived yet",
+                    MakeTraceSourceAccessor(&Peer::m_unconfirmedCount),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("FetchesIssued", "Record fetching interests sent, including retransmissions",
+                    MakeTraceSourceAccessor(&Peer::m_fetchesIssued),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("FetchesSatisfied", "Record fetches completed by an arriving record",
+                    MakeTraceSourceAccessor(&Peer::m_fetchesSatisfied),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("FetchesDuplicated", "Fetch requests dropped as the record is known or already fetched",
+                    MakeTraceSourceAccessor(&Peer::m_fetchesDuplicated),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("FetchesTimedOut", "Record fetching interests that timed out",
+                    MakeTraceSourceAccessor(&Peer::m_fetchesTimedOut),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("SyncsSent", "SYNC Interests sent, periodic ones and replies",
+                    MakeTraceSourceAccessor(&Peer::m_syncsSent),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("SyncRepliesSent", "SYNC Interests sent in reply to SYNCs with stale tips",
+                    MakeTraceSourceAccessor(&Peer::m_syncRepliesSent),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("SyncRepliesSuppressed",
+                    "SYNC replies coalesced with a scheduled one, or dropped as another SYNC covered them",
+                    MakeTraceSourceAccessor(&Peer::m_syncRepliesSuppressed),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("CatchUpsStarted", "Bulk catch-ups requested from a producer",
+                    MakeTraceSourceAccessor(&Peer::m_catchUpsStarted),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("RecordsCaughtUp", "Records received in catch-up segments",
+                    MakeTraceSourceAccessor(&Peer::m_recordsCaughtUp),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("CheckpointsGenerated", "Checkpoint records generated",
+                    MakeTraceSourceAccessor(&Peer::m_checkpointsGenerated),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("CheckpointsRejected", "Checkpoint records dropped for a wrong Merkle root",
+                    MakeTraceSourceAccessor(&Peer::m_checkpointsRejected),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("CheckpointsUnverified",
+                    "Checkpoint records admitted without a root check, as their frontier is unknown "
+                    "or its history reaches past the checkpoint this peer bootstrapped from",
+                    MakeTraceSourceAccessor(&Peer::m_checkpointsUnverified),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("RecordsPruned", "Archived records whose Data was released",
+                    MakeTraceSourceAccessor(&Peer::m_recordsPruned),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("RecordsPushed", "Records received in NOTIF Interests, each saving a fetch",
+                    MakeTraceSourceAccessor(&Peer::m_recordsPushed),
+                    "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource("Confirmed", "Record archived, with the latency since it was admitted",
+                    MakeTraceSourceAccessor(&Peer::m_confirmed),
+                    "ns3::ndn::Peer::ConfirmationCallback")
+    .AddTraceSource("RecordGenerated", "Record generated by this peer",
+                    MakeTraceSourceAccessor(&Peer::m_recordGenerated),
+                    "ns3::ndn::Peer::RecordCallback")
+    .AddTraceSource("NotifReceived", "NOTIF Interest received for a record",
+                    MakeTraceSourceAccessor(&Peer::m_notifReceived),
+                    "ns3::ndn::Peer::RecordCallback")
+    .AddTraceSource("RecordFetched", "Record that is not known yet arrived",
+                    MakeTraceSourceAccessor(&Peer::m_recordFetched),
+                    "ns3::ndn::Peer::RecordCallback")
+    .AddTraceSource("RecordPushed", "Record that is not known yet arrived in its NOTIF Interest",
+                    MakeTraceSourceAccessor(&Peer::m_recordPushed),
+                    "ns3::ndn::Peer::RecordCallback")
+    .AddTraceSource("RecordPending", "Record buffered until its ancestors arrive",
+                    MakeTraceSourceAccessor(&Peer::m_recordPending),
+                    "ns3::ndn::Peer::RecordCallback")
+    .AddTraceSource("RecordAdmitted", "Record attached to the ledger",
+                    MakeTraceSourceAccessor(&Peer::m_recordAdmitted),
+                    "ns3::ndn::Peer::RecordCallback")
+    .AddTraceSource("RecordArchived", "Record archived, as enough peers approved it",
+                    MakeTraceSourceAccessor(&Peer::m_recordArchived),
+                    "ns3::ndn::Peer::RecordCallback")
+    .AddTraceSource("WeightPropagation",
+                    "Records visited and DAG depth reached when propagating the weight of an admitted record",
+                    MakeTraceSourceAccessor(&Peer::m_weightPropagation),
+                    "ns3::ndn::Peer::WeightPropagationCallback");
   return tid;
 }
 
 Peer::Peer()
   : m_firstTime(true)
   , m_syncFirstTime(true)
+  , m_tipRandom(CreateObject<UniformRandomVariable>())
+  , m_visitEpoch(0)
+  , m_fetchRtt(CreateObject<RttMeanDeviation>())
+  , m_fetchesIssued(0)
+  , m_fetchesSatisfied(0)
+  , m_fetchesDuplicated(0)
+  , m_fetchesTimedOut(0)
+  , m_recordsPushed(0)
+  , m_syncReplyRandom(CreateObject<UniformRandomVariable>())
+  , m_syncsSent(0)
+  , m_syncRepliesSent(0)
+  , m_syncRepliesSuppressed(0)
+  , m_catchUpsStarted(0)
+  , m_recordsCaughtUp(0)
+  , m_archivedCount(0)
+  , m_lastCheckpointArchived(0)
+  , m_latestCheckpoint(INVALID_RECORD_ID)
+  , m_isBootstrapping(false)
+  , m_checkpointRequestRetx(0)
+  , m_checkpointsGenerated(0)
+  , m_checkpointsRejected(0)
+  , m_checkpointsUnverified(0)
+  , m_recordsPruned(0)
+  , m_unconfirmedHead(INVALID_RECORD_ID)
+  , m_unconfirmedTail(INVALID_RECORD_ID)
+  , m_unconfirmedCount(0)
   //, m_reqCounter(0)
 {
 }
 
-std::vector<std::string>
-Peer::GetApprovedBlocks(shared_ptr<const Data> data)
+Name
+Peer::GetRecordName(RecordId recordId) const
 {
-  std::vector<std::string> approvedBlocks;
-  auto content = ::ndn::encoding::readString(data->getContent());
-  int nSlash = 0;
-  const char *st, *ed;
-  for(st = ed = content.c_str(); *ed && *ed != '*'; ed ++){
-    if(*ed == ':'){
-      if(nSlash >= 2){
-        approvedBlocks.push_back(std::string(st, ed));
-      }
-      nSlash = 0;
-      st = ed + 1;
-    }else if(*ed == '/'){
-      nSlash ++;
-    }
-  }
-  if(nSlash >= 2){
-    approvedBlocks.push_back(std::string(st, ed));
+  const auto& record = m_ledger[recordId];
+  if (record.block != nullptr) {
+    return record.block->getName();
   }
 
-  return approvedBlocks;
+  Name recordName(m_mcPrefix);
+  recordName.append(m_producers[record.producer]);
+  recordName.append(::ndn::toHex(record.digest.data(), record.digest.size()));
+  return recordName;
 }
 
+Name
+Peer::GetRecordName(const ApprovalEdge& approval) const
+{
+  Name recordName(m_mcPrefix);
+  recordName.append(approval.producer);
+  recordName.append(::ndn::toHex(approval.digest.data(), approval.digest.size()));
+  return recordName;
+}
 
 void
 Peer::AddRevocation(shared_ptr<const Data> data)
 {
-  auto content = ::ndn::encoding::readString(data->getContent());
-  size_t pos = 0;
-  pos = content.find("***");
-  content = content.substr(pos + 3);
-  m_blackList.push_back(content);
+  RecordContent content;
+  if (!content.WireDecode(data->getContent()) || content.payloadType != RecordContent::REVOCATION) {
+    return;
+  }
+
+  auto producer = name::Component::fromEscapedString(content.payload);
+  if (m_blackList.insert(producer).second) {
+    EvictRevokedPending(producer);
+  }
+}
+
+void
+Peer::EvictRevokedPending(const name::Component& producer)
+{
+  std::unordered_set<RecordDigest, RecordDigestHash> evicted;
+  std::vector<RecordDigest> queue;
+  for (const auto& pending : m_pendingRecords) {
+    if (pending.second.record.block->getName().get(1) == producer) {
+      evicted.insert(pending.first);
+      queue.push_back(pending.first);
+    }
+  }
+
+  // a revoked record is never admitted, so the records waiting on it would stay pending forever
+  while (!queue.empty()) {
+    auto waiting = m_waitingOn.find(queue.back());
+    queue.pop_back();
+    if (waiting == m_waitingOn.end()) {
+      continue;
+    }
+    for (const auto& dependent : waiting->second) {
+      if (m_pendingRecords.count(dependent) > 0 && evicted.insert(dependent).second) {
+        queue.push_back(dependent);
+      }
+    }
+    m_waitingOn.erase(waiting);
+  }
+
+  for (const auto& digest : evicted) {
+    auto pending = m_pendingRecords.find(digest);
+    NS_LOG_INFO("EVICT REVOKED " << pending->second.record.block->getName());
+
+    // an ancestor nothing else waits on no longer holds back record generation
+    for (const auto& approvee : pending->second.record.approvedBlocks) {
+      auto waiting = m_waitingOn.find(approvee.digest);
+      if (waiting == m_waitingOn.end()) {
+        continue;
+      }
+      auto& dependents = waiting->second;
+      dependents.erase(std::remove(dependents.begin(), dependents.end(), digest), dependents.end());
+      if (dependents.empty()) {
+        m_waitingOn.erase(waiting);
+        m_missingRecords.erase(approvee.digest);
+      }
+    }
+    m_pendingRecords.erase(pending);
+  }
 }
 
 void
@@ -241,20 +446,42 @@ Peer::StartApplication()
   FibHelper::AddRoute(GetNode(), m_mcPrefix, m_face, 0);
 
   // create genesis blocks in the DLedger
+  // Naming: /dledger/genesis/digest, the same on every peer
+  RecordId firstGenesis = INVALID_RECORD_ID;
   for (int i = 0; i < m_genesisNum; i++) {
+    std::istringstream sha256Is("genesis" + std::to_string(i));
+    ::ndn::util::Sha256 sha(sha256Is);
     Name genesisName(m_mcPrefix);
     genesisName.append("genesis");
-    genesisName.append("genesis" + std::to_string(i));
+    genesisName.append(sha.toString());
     auto genesis = std::make_shared<Data>(genesisName);
-    auto genesisNameStr = genesisName.toUri();
-    m_tipList.push_back(genesisNameStr);
-    m_ledger.insert(std::pair<std::string, LedgerRecord>(genesisNameStr, LedgerRecord(genesis)));
+    RecordDigest genesisDigest;
+    Ledger::GetDigest(genesisName, genesisDigest);
+    auto genesisId = AdmitRecord(LedgerRecord(genesis), genesisDigest);
+    if (i == 0) {
+      firstGenesis = genesisId;
+    }
   }
 
   if (m_routablePrefix != m_idManagerPrefix) {
     ScheduleNextGeneration();
   } else {
-    m_lastRevocation = m_mcPrefix.toUri() + "/genesis/genesis0";
+    m_lastRevocation = firstGenesis;
+  }
+
+  if (m_pruneDepth > 0 && !m_spillFilePrefix.empty()) {
+    m_spillFile.open(m_spillFilePrefix + "-" + std::to_string(GetNode()->GetId()),
+                     std::ios_base::in | std::ios_base::out | std::ios_base::trunc
+                     | std::ios_base::binary);
+    if (!m_spillFile.is_open()) {
+      NS_FATAL_ERROR("Cannot open the spill file " << m_spillFilePrefix);
+    }
+  }
+
+  // the genesis records stay, as every checkpoint builds on them
+  if (m_bootstrapFromCheckpoint) {
+    m_isBootstrapping = true;
+    SendCheckpointRequest();
   }
 
   ScheduleNextSync();
@@ -265,111 +492,194 @@ void
 Peer::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
+  Simulator::Cancel(m_fetchRetxEvent);
+  Simulator::Cancel(m_syncReplyEvent);
+  if (m_spillFile.is_open()) {
+    m_spillFile.close();
+  }
   // cleanup App
   App::StopApplication();
 }
 
+int64_t
+Peer::AssignStreams(int64_t stream)
+{
+  int64_t used = 0;
+  m_tipRandom->SetStream(stream + used++);
+  m_syncReplyRandom->SetStream(stream + used++);
+  if (m_random != 0) {
+    m_random->SetStream(stream + used++);
+  }
+  if (m_syncRandom != 0) {
+    m_syncRandom->SetStream(stream + used++);
+  }
+  return used;
+}
+
+SyncState
+Peer::BuildSyncState() const
+{
+  std::vector<RecordId> tips(m_tips.GetEligible());
+  tips.insert(tips.end(), m_tips.GetIneligible().begin(), m_tips.GetIneligible().end());
+
+  // advertise a uniform sample of at most m_maxSyncTips tips; peers reconcile the rest over later rounds
+  size_t count = std::min<size_t>(tips.size(), m_maxSyncTips);
+  SyncState state;
+  for (size_t i = 0; i != count; i++) {
+    if (count < tips.size()) {
+      std::swap(tips[i], tips[m_tipRandom->GetInteger(i, tips.size() - 1)]);
+    }
+    state.AddTip(GetRecordName(tips[i]));
+  }
+  return state;
+}
+
+Name
+Peer::BuildSyncName() const
+{
+  Name syncName(m_mcPrefix);
+  syncName.append("SYNC");
+  syncName.append(BuildSyncState().WireEncode());
+  return syncName;
+}
+
+bool
+Peer::IsEligibleTip(RecordId id) const
+{
+  // cannot select a block generated by myself
+  // cannot select a confirmed block
+  const auto& record = m_ledger[id];
+  return !record.isArchived && !m_routablePrefix.isPrefixOf(record.block->getName());
+}
+
 // Triggers sync interest
 void
 Peer::GenerateSync()
 {
-  Name syncName(m_mcPrefix);
-  syncName.append("SYNC");
-  for (size_t i = 0; i != m_tipList.size(); i++) {
-    syncName.append(m_tipList[i]);
+  // tips of a bootstrapping peer are only its genesis records
+  if (m_isBootstrapping) {
+    ScheduleNextSync();
+    return;
+  }
+  SendSync();
+  ScheduleNextSync();
+}
+
+void
+Peer::SendSync()
+{
+  if (m_syncReplyEvent.IsRunning()) {
+    // this SYNC advertises the same tips as the scheduled reply
+    m_syncReplyEvent.Cancel();
+    m_syncRepliesSuppressed++;
   }
 
-  auto syncInterest = std::make_shared<Interest>(syncName);
+  auto syncInterest = std::make_shared<Interest>(BuildSyncName());
   NS_LOG_INFO("> SYNC Interest " << syncInterest->getName().toUri());
   m_transmittedInterests(syncInterest, this, m_face);
   m_appLink->onReceiveInterest(*syncInterest);
+  m_syncsSent++;
+}
 
-  ScheduleNextSync();
+void
+Peer::ScheduleSyncReply(const Interest& syncInterest)
+{
+  if (m_syncReplyEvent.IsRunning()) {
+    m_syncRepliesSuppressed++;
+    return;
+  }
+
+  // peers close to the stale one reply first, and their reply suppresses the ones further away
+  uint64_t hopCount = 0;
+  auto hopCountTag = syncInterest.getTag<lp::HopCountTag>();
+  if (hopCountTag != nullptr) {
+    hopCount = *hopCountTag;
+  }
+  Time delay = Seconds(m_syncReplyDelay.GetSeconds() * (hopCount + m_syncReplyRandom->GetValue()));
+  m_syncReplyEvent = Simulator::Schedule(delay, &Peer::SendSyncReply, this);
+}
+
+void
+Peer::SendSyncReply()
+{
+  NS_LOG_INFO("SYNC reply");
+  SendSync();
+  m_syncRepliesSent++;
 }
 
-std::set<std::string>
+std::set<RecordId>
 Peer::SelectApprovals(bool revocation){
-  std::set<std::string> selectedBlocks;
-  int tryTimes = 0;
-  for (int i = 0; i < m_referredNum; i++) {
-    auto referenceIndex = rand() % (m_tipList.size() - 1);
-    auto reference = m_tipList.at(referenceIndex);
-    bool isArchived = m_ledger.find(reference)->second.isArchived;
-
-    // cannot select a block generated by myself
-    // cannot select a confirmed block
-    while (m_routablePrefix.isPrefixOf(reference) || isArchived) {
-      referenceIndex = rand() % (m_tipList.size() - 1);
-      reference = m_tipList.at(referenceIndex);
-      isArchived = m_ledger.find(reference)->second.isArchived;
-    }
-    selectedBlocks.insert(reference);
-    if (i == m_referredNum - 1 && selectedBlocks.size() < 2) {
-      i--;
-      tryTimes++;
-      if (tryTimes > 10) {
-        NS_LOG_INFO("Try times used up: " << tryTimes);
-        if (!revocation){
-          ScheduleNextGeneration();
-        }
-        return std::set<std::string>();
-      }
+  // own and confirmed tips are kept in the ineligible pool, so sampling never retries;
+  // a record approves at least two tips, whatever ReferredNum says
+  auto sampled = m_tips.SampleEligible(std::max<size_t>(m_referredNum, 2), m_tipRandom);
+  if (sampled.size() < 2) {
+    NS_LOG_INFO("Not enough eligible tips: " << m_tips.EligibleSize());
+    if (!revocation){
+      ScheduleNextGeneration();
     }
+    return std::set<RecordId>();
   }
+  std::set<RecordId> selectedBlocks(sampled.begin(), sampled.end());
   if (revocation) {
     selectedBlocks.insert(m_lastRevocation);
   }
   return selectedBlocks;
 }
 
-std::string 
-Peer::BuildRecordContent(std::set<std::string> selectedBlocks, std::string specific_info)
+Block
+Peer::BuildRecordContent(const std::set<RecordId>& selectedBlocks, uint64_t payloadType,
+                         const std::string& payload)
 {
-  std::string recordContent = "";
+  RecordContent recordContent;
   for (const auto& item : selectedBlocks) {
-    recordContent += ":";
-    recordContent += item;
-    m_tipList.erase(std::remove(m_tipList.begin(),
-                                m_tipList.end(), item), m_tipList.end());
+    recordContent.AddApproval(GetRecordName(item));
+    m_tips.Erase(item);
   }
-  // to avoid the same digest made by multiple peers, add peer specific info
-  recordContent += "***";
-  recordContent += specific_info;
+  // to avoid the same digest made by multiple peers, the payload carries peer specific info
+  recordContent.payloadType = payloadType;
+  recordContent.payload = payload;
 
-  return recordContent;
+  return recordContent.WireEncode();
 }
 
 void
-Peer::GenerateRecordDataAndNotify(std::string recordContent, bool revocation)
+Peer::GenerateRecordDataAndNotify(const std::set<RecordId>& selectedBlocks, const Block& recordContent,
+                                  uint64_t payloadType)
 {
+  bool revocation = payloadType == RecordContent::REVOCATION;
 
   // generate digest as a name component
-  std::istringstream sha256Is(recordContent);
-  ::ndn::util::Sha256 sha(sha256Is);
+  ::ndn::util::Sha256 sha;
+  sha.update(recordContent.wire(), recordContent.size());
   std::string recordDigest = sha.toString();
-  sha.reset();
 
   // generate a new record
   // Naming: /dledger/nodeX/digest
   Name recordName(m_routablePrefix);
   recordName.append(recordDigest);
   auto record = std::make_shared<Data>(recordName);
-  record->setContent(::ndn::encoding::makeStringBlock(::ndn::tlv::Content, recordContent));
+  record->setContent(recordContent);
   ndn::StackHelper::getKeyChain().sign(*record);
 
-  // attach to local ledger
-  m_ledger.insert(std::pair<std::string, LedgerRecord>(recordName.toUri(), LedgerRecord(record)));
-  // add to tip list
-  m_tipList.push_back(recordName.toUri());
+  RecordDigest digest;
+  Ledger::GetDigest(recordName, digest);
+  m_recordGenerated(this, digest, INVALID_RECORD_ID);
 
+  // attach to local ledger, add to tip list and
   // update weights of directly or indirectly approved blocks
-  std::set<std::string> visited;
-  UpdateWeightAndEntropy(record, visited, recordName.getSubName(0, 2).toUri());
-  NS_LOG_INFO("NewRecord: visited records size: " << visited.size()
-              << " unconfirmed depth: " << log2(visited.size() + 1));
+  LedgerRecord ledgerRecord(record);
+  ledgerRecord.isCheckpoint = payloadType == RecordContent::CHECKPOINT;
+  ledgerRecord.approvals.assign(selectedBlocks.begin(), selectedBlocks.end());
+  auto recordId = AdmitRecord(ledgerRecord, digest);
 
   Name notifName(m_mcPrefix);
-  notifName.append("NOTIF").append(m_routablePrefix.getSubName(1).toUri()).append(recordDigest);
+  notifName.append("NOTIF").append(m_routablePrefix.getSubName(m_mcPrefix.size())).append(recordDigest);
+  // small records travel as the last component of the NOTIF, saving every receiver a fetch
+  // round trip (Interests of the bundled ndn-cxx have no parameters)
+  const auto& recordWire = record->wireEncode();
+  if (recordWire.size() <= m_maxPushSize) {
+    notifName.append(name::Component(recordWire.wire(), recordWire.size()));
+  }
   auto notif = std::make_shared<Interest>(notifName);
 
   NS_LOG_INFO("> NOTIF Interest " << notif->getName().toUri());
@@ -379,7 +689,7 @@ Peer::GenerateRecordDataAndNotify(std::string recordContent, bool revocation)
   if (!revocation) {
     ScheduleNextGeneration();
   } else {
-    m_lastRevocation = recordName.toUri();
+    m_lastRevocation = recordId;
   }
 }
   
@@ -397,9 +707,9 @@ Peer::GenerateRevocation(std::string revoked_node)
     return;
   }
 
-  auto recordContent = BuildRecordContent(selectedBlocks, revoked_node);
+  auto recordContent = BuildRecordContent(selectedBlocks, RecordContent::REVOCATION, revoked_node);
 
-  GenerateRecordDataAndNotify(recordContent, true);
+  GenerateRecordDataAndNotify(selectedBlocks, recordContent, RecordContent::REVOCATION);
 
 }
 
@@ -408,6 +718,10 @@ void
 Peer::GenerateRecord()
 {
   NS_LOG_FUNCTION_NOARGS();
+  if (m_isBootstrapping) {
+    ScheduleNextGeneration();
+    return;
+  }
   if (m_missingRecords.size() > 0) {
     NS_LOG_INFO("Missing record number: " << m_missingRecords.size());
     ScheduleNextGeneration();
@@ -419,71 +733,468 @@ Peer::GenerateRecord()
     return;
   }
 
-  auto recordContent = BuildRecordContent(selectedBlocks, m_routablePrefix.toUri());
+  // every CheckpointInterval archived records, the next record of this peer is a checkpoint
+  uint64_t payloadType = RecordContent::APP_DATA;
+  std::string payload = m_routablePrefix.toUri();
+  if (m_checkpointInterval > 0
+      && m_archivedCount >= m_lastCheckpointArchived + m_checkpointInterval) {
+    Checkpoint checkpoint;
+    if (BuildCheckpoint(checkpoint)) {
+      payloadType = RecordContent::CHECKPOINT;
+      payload = checkpoint.WireEncode();
+      m_checkpointsGenerated++;
+      NS_LOG_INFO("CHECKPOINT of " << checkpoint.frontier.size() << " frontier records");
+    }
+    m_lastCheckpointArchived = m_archivedCount;
+  }
+
+  auto recordContent = BuildRecordContent(selectedBlocks, payloadType, payload);
 
-  GenerateRecordDataAndNotify(recordContent, false);
+  GenerateRecordDataAndNotify(selectedBlocks, recordContent, payloadType);
 }
 
+// The frontier is the archived records that no archived record approves
+bool
+Peer::BuildCheckpoint(Checkpoint& checkpoint)
+{
+  uint32_t epoch = NextVisitEpoch();
+  for (RecordId id = 0; id != m_ledger.size(); id++) {
+    if (m_ledger[id].isArchived) {
+      for (auto approvedBlock : m_ledger[id].approvals) {
+        m_ledger[approvedBlock].visitEpoch = epoch;
+      }
+    }
+  }
 
-// Update weights
+  for (RecordId id = 0; id != m_ledger.size(); id++) {
+    if (m_ledger[id].isArchived && m_ledger[id].visitEpoch != epoch) {
+      checkpoint.AddFrontier(GetRecordName(id));
+    }
+  }
+  return ComputeArchivedRoot(checkpoint.frontier, checkpoint.merkleRoot) == ROOT_COMPUTED;
+}
+
+Peer::RootStatus
+Peer::ComputeArchivedRoot(const std::vector<ApprovalEdge>& frontier, RecordDigest& root)
+{
+  uint32_t epoch = NextVisitEpoch();
+  m_propagationStack.clear();
+  for (const auto& edge : frontier) {
+    auto id = m_ledger.find(edge.digest);
+    if (id == INVALID_RECORD_ID) {
+      return ROOT_UNKNOWN_FRONTIER;
+    }
+    if (m_ledger[id].visitEpoch != epoch) {
+      m_ledger[id].visitEpoch = epoch;
+      m_propagationStack.push_back(std::make_pair(id, 0));
+    }
+  }
+
+  std::vector<RecordDigest> digests;
+  while (!m_propagationStack.empty()) {
+    auto current = m_propagationStack.back().first;
+    m_propagationStack.pop_back();
+
+    if (m_ledger[current].hasHistoryGap) {
+      return ROOT_HISTORY_GAP;
+    }
+    digests.push_back(m_ledger[current].digest);
+
+    for (auto approvedBlock : m_ledger[current].approvals) {
+      if (m_ledger[approvedBlock].visitEpoch != epoch) {
+        m_ledger[approvedBlock].visitEpoch = epoch;
+        m_propagationStack.push_back(std::make_pair(approvedBlock, 0));
+      }
+    }
+  }
+
+  root = Checkpoint::ComputeMerkleRoot(std::move(digests));
+  return ROOT_COMPUTED;
+}
+
+
+// Attach a record to the ledger and propagate its approvals
+RecordId
+Peer::AdmitRecord(LedgerRecord record, const RecordDigest& digest)
+{
+  auto approver = GetProducerOrdinal(record.block->getName().get(1));
+  // parsed edges are only needed until the approvals are resolved to IDs
+  std::vector<ApprovalEdge>().swap(record.approvedBlocks);
+  record.producer = approver;
+  auto recordId = m_ledger.insert(std::move(record), digest);
+  m_recordAdmitted(this, digest, recordId);
+
+  // join the tail of the unconfirmed list
+  auto& admitted = m_ledger[recordId];
+  admitted.admissionTime = Simulator::Now();
+  admitted.prevUnconfirmed = m_unconfirmedTail;
+  if (m_unconfirmedTail != INVALID_RECORD_ID) {
+    m_ledger[m_unconfirmedTail].nextUnconfirmed = recordId;
+  }
+  else {
+    m_unconfirmedHead = recordId;
+  }
+  m_unconfirmedTail = recordId;
+  m_unconfirmedCount++;
+
+  m_tips.Insert(recordId, IsEligibleTip(recordId));
+  for (const auto& approvee : m_ledger[recordId].approvals) {
+    m_tips.Erase(approvee);
+  }
+
+  UpdateWeightAndEntropy(recordId, approver);
+  return recordId;
+}
+
+uint32_t
+Peer::GetProducerOrdinal(const name::Component& producer)
+{
+  auto result = m_producerOrdinals.insert(std::make_pair(producer, m_producers.size()));
+  if (result.second) {
+    m_producers.push_back(producer);
+  }
+  return result.first->second;
+}
+
+// Starts a new walk of the ledger, whose marks are compared with LedgerRecord::visitEpoch
+uint32_t
+Peer::NextVisitEpoch()
+{
+  if (++m_visitEpoch == 0) {
+    // epoch wrapped around: clear stale marks so that no record looks visited
+    for (RecordId id = 0; id != m_ledger.size(); id++) {
+      m_ledger[id].visitEpoch = 0;
+    }
+    m_visitEpoch = 1;
+  }
+  return m_visitEpoch;
+}
+
+// Update weights of all records directly or indirectly approved by tail.
+// The walk is iterative and stops at archived records, which form the frontier of the unconfirmed DAG,
+// and at records the approver already approved: their ancestors carry the approver as well, since
+// records are admitted only after all their ancestors.
+// Weight is therefore exact for direct approvals and a lower bound for indirect ones.
 void
-Peer::UpdateWeightAndEntropy(shared_ptr<const Data> tail, std::set<std::string>& visited, std::string nodeName) {
-  auto tailName = tail->getName().toUri();
-  //std::cout << tail->getName().getSubName(0, 2).toUri() << std::endl;
-  visited.insert(tailName);
-  // std::cout << "visited set size: " << visited.size() << std::endl;
+Peer::UpdateWeightAndEntropy(RecordId tail, uint32_t approver)
+{
+  NextVisitEpoch();
 
-  std::vector<std::string> approvedBlocks = GetApprovedBlocks(tail);
-  std::set<std::string> processed;
+  uint32_t nVisited = 1;
+  uint32_t maxDepth = 0;
+  m_ledger[tail].visitEpoch = m_visitEpoch;
+  m_propagationStack.clear();
+  m_propagationStack.push_back(std::make_pair(tail, 0));
 
-  for (size_t i = 0; i != approvedBlocks.size(); i++) {
-    auto approvedBlock = approvedBlocks[i];
+  while (!m_propagationStack.empty()) {
+    auto current = m_propagationStack.back();
+    m_propagationStack.pop_back();
 
-    // this approvedblock shouldnt be previously processed to avoid increasing weight multiple times
-    // (this condition is when multiple references point to same block)
-    auto search = processed.find(approvedBlock);
-    if (search == processed.end()) {
+    // the arena is not appended to while propagating, so references stay valid
+    for (auto approvedBlock : m_ledger[current.first].approvals) {
+      auto& approved = m_ledger[approvedBlock];
 
       // do not increase weight if block has been previously visited
-      // (this condition is useful when different chains merge)
-      auto search2 = visited.find(approvedBlock);
-      if (search2 == visited.end()) {
-
-        auto it = m_ledger.find(approvedBlock);
-        if (it != m_ledger.end()) { // this should always return true
-          it->second.weight += 1;
-          it->second.approverNames.insert(nodeName);
-          it->second.entropy = it->second.approverNames.size();
-          if (it->second.entropy >= m_entropyThreshold) {
-            it->second.isArchived = true;
-            if (it->second.isASample && this->m_node->GetId() == 0) {
-              auto time = Simulator::Now() - it->second.creationTime;
-              uint64_t period = time.ToInteger(Time::MS);
-              std::cout << period << std::endl;
-              it->second.isASample = false;
-            }
-            continue;
-          }
-          processed.insert(approvedBlock);
-          UpdateWeightAndEntropy(it->second.block, visited, nodeName);
+      // (this condition is useful when different chains merge or
+      // when multiple references point to same block)
+      if (approved.visitEpoch == m_visitEpoch) {
+        continue;
+      }
+      approved.visitEpoch = m_visitEpoch;
+      nVisited++;
+      maxDepth = std::max(maxDepth, current.second + 1);
+
+      approved.weight += 1;
+      // a pruned record is archived and no longer tracks its approvers
+      if (approved.block == nullptr) {
+        continue;
+      }
+      if (!approved.approvers.Insert(approver)) {
+        continue;
+      }
+      approved.entropy = approved.approvers.size();
+      if (approved.entropy >= m_entropyThreshold) {
+        if (!approved.isArchived) {
+          ArchiveRecord(approvedBlock);
         }
-        else {
-          NS_LOG_ERROR("it == m_ledger.end(): " << approvedBlock);
-          throw 0;
+        continue;
+      }
+      m_propagationStack.push_back(std::make_pair(approvedBlock, current.second + 1));
+    }
+  }
+
+  m_weightPropagation(this, tail, nVisited, maxDepth);
+}
+
+void
+Peer::ArchiveRecord(RecordId recordId)
+{
+  auto& record = m_ledger[recordId];
+  record.isArchived = true;
+  m_tips.SetEligible(recordId, false);
+  m_archivedCount++;
+  if (record.isCheckpoint
+      && (m_latestCheckpoint == INVALID_RECORD_ID || recordId > m_latestCheckpoint)) {
+    m_latestCheckpoint = recordId;
+  }
+
+  // leave the unconfirmed list
+  if (record.prevUnconfirmed != INVALID_RECORD_ID) {
+    m_ledger[record.prevUnconfirmed].nextUnconfirmed = record.nextUnconfirmed;
+  }
+  else {
+    m_unconfirmedHead = record.nextUnconfirmed;
+  }
+  if (record.nextUnconfirmed != INVALID_RECORD_ID) {
+    m_ledger[record.nextUnconfirmed].prevUnconfirmed = record.prevUnconfirmed;
+  }
+  else {
+    m_unconfirmedTail = record.prevUnconfirmed;
+  }
+  record.prevUnconfirmed = record.nextUnconfirmed = INVALID_RECORD_ID;
+  m_unconfirmedCount--;
+
+  Time latency = Simulator::Now() - record.admissionTime;
+  size_t bin = 0;
+  if (m_latencyBinWidth.IsPositive()) {
+    bin = latency.GetNanoSeconds() / m_latencyBinWidth.GetNanoSeconds();
+  }
+  if (bin >= m_confirmationLatency.size()) {
+    m_confirmationLatency.resize(bin + 1, 0);
+  }
+  m_confirmationLatency[bin]++;
+  m_confirmed(this, recordId, latency);
+  m_recordArchived(this, record.digest, recordId);
+
+  if (m_pruneDepth > 0) {
+    m_archivedQueue.push_back(recordId);
+    while (m_archivedQueue.size() > m_pruneDepth) {
+      PruneRecord(m_archivedQueue.front());
+      m_archivedQueue.pop_front();
+    }
+  }
+}
+
+void
+Peer::PruneRecord(RecordId recordId)
+{
+  auto& record = m_ledger[recordId];
+  if (m_spillFile.is_open()) {
+    const auto& wire = record.block->wireEncode();
+    m_spillFile.seekp(0, std::ios_base::end);
+    m_spillEntries[recordId] = SpillEntry{static_cast<uint64_t>(m_spillFile.tellp()),
+                                          static_cast<uint32_t>(wire.size())};
+    m_spillFile.write(reinterpret_cast<const char*>(wire.wire()), wire.size());
+  }
+
+  record.block.reset();
+  record.approvers = ApproverSet();
+  m_recordsPruned++;
+}
+
+size_t
+Peer::GetRecordWireSize(RecordId recordId) const
+{
+  const auto& record = m_ledger[recordId];
+  if (record.block != nullptr) {
+    return record.block->wireEncode().size();
+  }
+
+  auto entry = m_spillEntries.find(recordId);
+  return entry != m_spillEntries.end() ? entry->second.size : 0;
+}
+
+shared_ptr<const Data>
+Peer::LoadRecord(RecordId recordId)
+{
+  const auto& record = m_ledger[recordId];
+  if (record.block != nullptr) {
+    return record.block;
+  }
+
+  auto entry = m_spillEntries.find(recordId);
+  if (entry == m_spillEntries.end()) {
+    return nullptr;
+  }
+  try {
+    m_spillFile.seekg(entry->second.offset);
+    return std::make_shared<Data>(Block::fromStream(m_spillFile));
+  }
+  catch (const ::ndn::tlv::Error&) {
+    NS_LOG_INFO("CORRUPT SPILL FILE at " << entry->second.offset);
+    m_spillFile.clear();
+    return nullptr;
+  }
+}
+
+uint32_t
+Peer::GetUnconfirmedCount() const
+{
+  return m_unconfirmedCount;
+}
+
+Time
+Peer::GetOldestUnconfirmedAge() const
+{
+  if (m_unconfirmedHead == INVALID_RECORD_ID) {
+    return Seconds(0);
+  }
+  return Simulator::Now() - m_ledger[m_unconfirmedHead].admissionTime;
+}
+
+// Queue an interest to fetch record
+void
+Peer::FetchRecord(const Name& recordName, const RecordDigest& digest)
+{
+  if (m_ledger.find(digest) != INVALID_RECORD_ID
+      || m_pendingRecords.find(digest) != m_pendingRecords.end()
+      || m_fetches.find(digest) != m_fetches.end()) {
+    m_fetchesDuplicated++;
+    return;
+  }
+
+  m_fetches[digest] = FetchEntry{recordName, Time(), 0, false};
+  m_fetchQueue.push_back(digest);
+  SendFetches();
+}
+
+// Send out interests to fetch records
+void
+Peer::SendFetches()
+{
+  while (m_inFlightFetches.size() < m_fetchWindow && !m_fetchQueue.empty()) {
+    auto digest = m_fetchQueue.front();
+    m_fetchQueue.pop_front();
+    auto it = m_fetches.find(digest);
+    if (it == m_fetches.end()) { // satisfied while queued
+      continue;
+    }
+
+    auto& entry = it->second;
+    entry.inFlight = true;
+    entry.sendTime = Simulator::Now();
+    m_inFlightFetches.push_back(digest);
+
+    auto recordInterest = std::make_shared<Interest>(entry.name);
+    m_transmittedInterests(recordInterest, this, m_face);
+    NS_LOG_INFO("> RECORD Interest " << recordInterest->getName().toUri());
+    m_appLink->onReceiveInterest(*recordInterest);
+    m_fetchesIssued++;
+  }
+  if (!m_inFlightFetches.empty()) {
+    ScheduleFetchTimeout();
+  }
+}
+
+void
+Peer::ScheduleFetchTimeout()
+{
+  if (!m_fetchRetxEvent.IsRunning()) {
+    m_fetchRetxEvent = Simulator::Schedule(m_fetchRetxTimer, &Peer::CheckFetchTimeout, this);
+  }
+}
+
+void
+Peer::CheckFetchTimeout()
+{
+  Time now = Simulator::Now();
+  Time rto = m_fetchRtt->RetransmitTimeout();
+
+  bool timedOut = false;
+  for (size_t i = 0; i < m_inFlightFetches.size(); ) {
+    auto digest = m_inFlightFetches[i];
+    auto& entry = m_fetches[digest];
+    if (entry.sendTime + rto > now) {
+      i++;
+      continue;
+    }
+
+    timedOut = true;
+    m_fetchesTimedOut++;
+    if (entry.retxCount < m_maxFetchRetx) {
+      NS_LOG_INFO("RETX " << entry.name);
+      entry.retxCount++;
+      entry.sendTime = now;
+      auto recordInterest = std::make_shared<Interest>(entry.name);
+      m_transmittedInterests(recordInterest, this, m_face);
+      m_appLink->onReceiveInterest(*recordInterest);
+      m_fetchesIssued++;
+      i++;
+    }
+    else {
+      // give up; a later SYNC, NOTIF or dependent record triggers a new fetch
+      NS_LOG_INFO("GIVE UP " << entry.name);
+      m_missingRecords.erase(digest);
+      m_fetches.erase(digest);
+      m_inFlightFetches[i] = m_inFlightFetches.back();
+      m_inFlightFetches.pop_back();
+    }
+  }
+
+  if (!m_catchUp.prefix.empty() && m_catchUp.lastProgress + rto <= now) {
+    timedOut = true;
+    if (m_catchUp.retxCount < m_maxFetchRetx) {
+      m_catchUp.retxCount++;
+      m_catchUp.lastProgress = now;
+      for (auto segment = m_catchUp.nextToAdmit; segment != m_catchUp.nextSegment; segment++) {
+        if (m_catchUp.received.count(segment) == 0) {
+          SendCatchUpInterest(segment);
         }
       }
     }
+    else {
+      // pending records still fetch their ancestors one by one
+      NS_LOG_INFO("GIVE UP " << m_catchUp.prefix);
+      if (m_catchUp.isFromCheckpoint) {
+        m_isBootstrapping = false;
+      }
+      m_catchUp = CatchUp();
+    }
+  }
+
+  if (m_isBootstrapping && m_catchUp.prefix.empty() && m_checkpointRequestTime + rto <= now) {
+    timedOut = true;
+    if (m_checkpointRequestRetx < m_maxFetchRetx) {
+      m_checkpointRequestRetx++;
+      SendCheckpointRequest();
+    }
+    else {
+      NS_LOG_INFO("NO CHECKPOINT, syncing from the genesis");
+      m_isBootstrapping = false;
+    }
+  }
+
+  if (timedOut) {
+    m_fetchRtt->IncreaseMultiplier(); // Double the next RTO
+  }
+  SendFetches();
+
+  // an idle peer has nothing to check until its next fetch, catch-up or checkpoint request
+  if (!m_inFlightFetches.empty() || !m_catchUp.prefix.empty() || m_isBootstrapping) {
+    ScheduleFetchTimeout();
   }
 }
 
-// Send out interest to fetch record
 void
-Peer::FetchRecord(Name recordName)
+Peer::OnFetchSatisfied(const RecordDigest& digest, bool isRttSample)
 {
-  auto recordInterest = std::make_shared<Interest>(recordName);
-  m_transmittedInterests(recordInterest, this, m_face);
-  NS_LOG_INFO("> RECORD Interest " << recordInterest->getName().toUri());
-  m_appLink->onReceiveInterest(*recordInterest);
+  auto it = m_fetches.find(digest);
+  if (it == m_fetches.end()) {
+    return;
+  }
+
+  if (it->second.inFlight) {
+    // Karn's algorithm: only sample RTT of fetches that were not retransmitted
+    if (isRttSample && it->second.retxCount == 0) {
+      m_fetchRtt->Measurement(Simulator::Now() - it->second.sendTime);
+      m_fetchRtt->ResetMultiplier();
+    }
+    m_inFlightFetches.erase(std::find(m_inFlightFetches.begin(), m_inFlightFetches.end(), digest));
+  }
+  m_fetches.erase(it);
+  m_fetchesSatisfied++;
+
+  SendFetches();
 }
 
 // Callback that will be called when Data arrives
@@ -492,104 +1203,500 @@ Peer::OnData(std::shared_ptr<const Data> data)
 {
   NS_LOG_INFO("OnData(): DATA= " << data->getName().toUri());
 
-  auto dataName = data->getName();
-  auto dataNameUri = dataName.toUri();
+  if (!m_catchUp.prefix.empty() && m_catchUp.prefix.isPrefixOf(data->getName())) {
+    OnCatchUpSegment(data);
+    return;
+  }
+  if (data->getName() == Name(m_mcPrefix).append("CHECKPOINT")) {
+    OnCheckpoint(data);
+    return;
+  }
+
+  // Application-level semantics
+  RecordDigest dataDigest;
+  if (!Ledger::GetDigest(data->getName(), dataDigest)) {
+    NS_LOG_INFO("Not a record name");
+    return;
+  }
+  OnFetchSatisfied(dataDigest, true);
+
+  ReceiveRecord(data, dataDigest, FETCHED);
+}
+
+void
+Peer::ReceiveRecord(shared_ptr<const Data> data, const RecordDigest& dataDigest,
+                    RecordSource source)
+{
+  const auto& dataName = data->getName();
 
-  bool approvedBlocksInLedger = true;
   bool isTailingRecord = false;
 
-  // Application-level semantics
-  auto it = m_ledger.find(dataNameUri);
-  if (it != m_ledger.end()){
+  if (m_blackList.count(dataName.get(1)) > 0) {
+    NS_LOG_INFO("Is a record from revoked entity");
+    m_missingRecords.erase(dataDigest);
     return;
   }
 
-  auto it2 = m_missingRecords.find(dataNameUri);
-  if (it2 == m_missingRecords.end()) {
-    NS_LOG_INFO("Is a Tailing Record");
-    isTailingRecord = true;
+  if (m_ledger.find(dataDigest) != INVALID_RECORD_ID
+      || m_pendingRecords.find(dataDigest) != m_pendingRecords.end()) {
+    return;
+  }
+  if (source == PUSHED) {
+    m_recordsPushed++;
+    m_recordPushed(this, dataDigest, INVALID_RECORD_ID);
   }
   else {
+    if (source == CAUGHT_UP) {
+      m_recordsCaughtUp++;
+    }
+    m_recordFetched(this, dataDigest, INVALID_RECORD_ID);
+  }
+
+  auto it2 = m_missingRecords.find(dataDigest);
+  // caught up records are old by design, the contribution policy is for new ones
+  if (it2 != m_missingRecords.end()) {
     m_missingRecords.erase(it2);
   }
+  else if (source != CAUGHT_UP) {
+    NS_LOG_INFO("Is a Tailing Record");
+    isTailingRecord = true;
+  }
 
-  auto it3 = find(m_blackList.begin(), m_blackList.end(), dataName.get(1).toUri());
-  if (it3 != m_blackList.end()) {
-    NS_LOG_INFO("Is a record from revoked entity");
+  RecordContent content;
+  if (!content.WireDecode(data->getContent())) {
+    NS_LOG_INFO("MALFORMED RECORD CONTENT");
     return;
   }
 
-  std::vector<std::string> approvedBlocks = GetApprovedBlocks(data);
-  m_recordStack.push_back(LedgerRecord(data));
-  for (size_t i = 0; i != approvedBlocks.size(); i++) {
-    auto approvedBlockName = Name(approvedBlocks[i]);
-    if (approvedBlockName.size() < 2) { // ignoring empty strings when splitting (:tip1:tip2)
-      NS_LOG_INFO("IGNORED " << approvedBlockName);
-      continue;
+  if (content.payloadType == RecordContent::CHECKPOINT) {
+    Checkpoint checkpoint;
+    if (!checkpoint.WireDecode(content.payload)) {
+      NS_LOG_INFO("MALFORMED CHECKPOINT");
+      return;
     }
-    if (approvedBlockName.get(1) == dataName.get(1) && dataName.get(1) != m_idManagerPrefix.get(1)) { // recordname format: /dledger/node/hash
-      m_recordStack.pop_back();
-      NS_LOG_INFO("INTERLOCK VIOLATION " << approvedBlockName);
+    // the root can only be checked over a known frontier whose history this peer has whole
+    RecordDigest root;
+    auto status = ComputeArchivedRoot(checkpoint.frontier, root);
+    if (status == ROOT_COMPUTED && root != checkpoint.merkleRoot) {
+      NS_LOG_INFO("CHECKPOINT ROOT MISMATCH " << dataName);
+      m_checkpointsRejected++;
       return;
     }
-    it = m_ledger.find(approvedBlocks[i]);
-    if (it == m_ledger.end()) {
-      approvedBlocksInLedger = false;
-      it2 = m_missingRecords.find(approvedBlocks[i]);
-      if (it2 == m_missingRecords.end()) {
-        m_missingRecords.insert(approvedBlocks[i]);
-        FetchRecord(approvedBlockName);
-        NS_LOG_INFO("GO TO FETCH " << approvedBlockName);
-      }
+    if (status != ROOT_COMPUTED) {
+      NS_LOG_INFO("CHECKPOINT UNVERIFIED " << dataName);
+      m_checkpointsUnverified++;
     }
-    else {
-      NS_LOG_INFO("EXISTS APPROVAL " << approvedBlockName);
-      if (isTailingRecord && it->second.entropy > m_conEntropy) {
+  }
+
+  // the suffix fetched after a checkpoint approves records the checkpoint stands in for
+  bool isAnchored = source == CAUGHT_UP && m_catchUp.isFromCheckpoint;
+
+  // validate all approvals before registering anything for the record
+  for (const auto& approvedBlock : content.approvals) {
+    if (approvedBlock.producer == dataName.get(1) && dataName.get(1) != m_idManagerPrefix.get(1)) { // recordname format: /dledger/node/hash
+      NS_LOG_INFO("INTERLOCK VIOLATION " << GetRecordName(approvedBlock));
+      return;
+    }
+    auto approvedId = m_ledger.find(approvedBlock.digest);
+    if (approvedId != INVALID_RECORD_ID) {
+      NS_LOG_INFO("EXISTS APPROVAL " << GetRecordName(approvedId));
+      if (isTailingRecord && m_ledger[approvedId].entropy > m_conEntropy) {
         NS_LOG_INFO("Break Contribution Policy!!");
         return;
       }
     }
   }
 
-  if (approvedBlocksInLedger) {
-    for(auto it = m_recordStack.rbegin(); it != m_recordStack.rend(); ){
-      NS_LOG_INFO("STACK SIZE " << m_recordStack.size());
+  LedgerRecord record(data);
+  record.isCheckpoint = content.payloadType == RecordContent::CHECKPOINT;
+  record.approvedBlocks = std::move(content.approvals);
 
-      const auto& record = *it;
-      auto recordName = record.block->getName().toUri();
-      approvedBlocks = GetApprovedBlocks(record.block);
-      bool ready = true;
-      for(const auto& approveeName : approvedBlocks){
-        if(m_ledger.find(approveeName) == m_ledger.end()){
-          ready = false;
-          break;
-        }
-      }
-      if(!ready){
-        it ++;
+  // index the record under each ancestor it is still waiting on
+  uint32_t nMissing = 0;
+  for (const auto& approvedBlock : record.approvedBlocks) {
+    if (m_ledger.find(approvedBlock.digest) != INVALID_RECORD_ID
+        || (isAnchored && m_pendingRecords.find(approvedBlock.digest) == m_pendingRecords.end())) {
+      continue;
+    }
+    nMissing++;
+    m_waitingOn[approvedBlock.digest].push_back(dataDigest);
+
+    // an ancestor that is itself pending has arrived already
+    if (m_pendingRecords.find(approvedBlock.digest) == m_pendingRecords.end()
+        && m_missingRecords.insert(approvedBlock.digest).second) {
+      auto approvedBlockName = GetRecordName(approvedBlock);
+      FetchRecord(approvedBlockName, approvedBlock.digest);
+      NS_LOG_INFO("GO TO FETCH " << approvedBlockName);
+    }
+  }
+
+  if (nMissing > 0) {
+    NS_LOG_INFO("PENDING " << dataName << " missing " << nMissing);
+    PendingRecord pending{std::move(record), nMissing};
+    m_pendingRecords.emplace(dataDigest, std::move(pending));
+    m_recordPending(this, dataDigest, INVALID_RECORD_ID);
+
+    // a long chain of missing ancestors is cheaper to fetch in bulk than one RTT per record
+    if (m_catchUpThreshold > 0 && m_pendingRecords.size() >= m_catchUpThreshold
+        && m_catchUp.prefix.empty()) {
+      StartCatchUp(dataName.get(1), BuildSyncState());
+    }
+    return;
+  }
+
+  AdmitWithDependents(std::move(record), dataDigest);
+}
+
+void
+Peer::AdmitWithDependents(LedgerRecord record, const RecordDigest& digest)
+{
+  AcceptRecord(std::move(record), digest);
+
+  // admitted records release their dependents breadth-first, which keeps topological order
+  std::deque<RecordDigest> admitted{digest};
+  while (!admitted.empty()) {
+    auto waiting = m_waitingOn.find(admitted.front());
+    admitted.pop_front();
+    if (waiting == m_waitingOn.end()) {
+      continue;
+    }
+
+    std::vector<RecordDigest> dependents;
+    dependents.swap(waiting->second);
+    m_waitingOn.erase(waiting);
+
+    for (const auto& dependent : dependents) {
+      auto pending = m_pendingRecords.find(dependent);
+      if (pending == m_pendingRecords.end() || --pending->second.nMissing > 0) {
         continue;
       }
+      NS_LOG_INFO("RELEASED " << pending->second.record.block->getName());
+      auto ready = std::move(pending->second.record);
+      m_pendingRecords.erase(pending);
+      AcceptRecord(std::move(ready), dependent);
+      admitted.push_back(dependent);
+    }
+  }
+}
 
-      NS_LOG_INFO("POPED " << record.block->getName());
-      m_tipList.push_back(recordName);
-      m_ledger.insert(std::pair<std::string, LedgerRecord>(record.block->getName().toUri(), record));
-      if (record.block->getName().getSubName(0, 2) == m_idManagerPrefix) {
-        AddRevocation(record.block);
+void
+Peer::AcceptRecord(LedgerRecord record, const RecordDigest& digest)
+{
+  record.approvals.clear();
+  record.approvals.reserve(record.approvedBlocks.size());
+  for (const auto& approvee : record.approvedBlocks) {
+    // only records caught up after a checkpoint have approvals outside the ledger
+    auto approveeId = m_ledger.find(approvee.digest);
+    if (approveeId != INVALID_RECORD_ID) {
+      record.approvals.push_back(approveeId);
+    }
+    else {
+      record.hasHistoryGap = true;
+    }
+  }
+
+  if (record.block->getName().getSubName(0, 2) == m_idManagerPrefix) {
+    AddRevocation(record.block);
+  }
+  AdmitRecord(std::move(record), digest);
+}
+
+// The ancestors of the frontier are marked in one walk; the rest of the arena, which is in
+// topological order, is what the requester lacks
+void
+Peer::CollectCatchUpRecords(const SyncState& frontier, std::vector<RecordId>& records)
+{
+  uint32_t epoch = NextVisitEpoch();
+
+  m_propagationStack.clear();
+  for (const auto& tip : frontier.tips) {
+    auto tipId = m_ledger.find(tip.digest);
+    if (tipId != INVALID_RECORD_ID && m_ledger[tipId].visitEpoch != epoch) {
+      m_ledger[tipId].visitEpoch = epoch;
+      m_propagationStack.push_back(std::make_pair(tipId, 0));
+    }
+  }
+
+  while (!m_propagationStack.empty()) {
+    auto current = m_propagationStack.back().first;
+    m_propagationStack.pop_back();
+    for (auto approvedBlock : m_ledger[current].approvals) {
+      if (m_ledger[approvedBlock].visitEpoch != epoch) {
+        m_ledger[approvedBlock].visitEpoch = epoch;
+        m_propagationStack.push_back(std::make_pair(approvedBlock, 0));
       }
+    }
+  }
 
-      for (size_t i = 0; i != approvedBlocks.size(); i++) {
-        m_tipList.erase(std::remove(m_tipList.begin(),
-                                    m_tipList.end(), approvedBlocks[i]), m_tipList.end());
+  records.clear();
+  for (RecordId id = 0; id != m_ledger.size(); id++) {
+    // every peer creates the genesis records itself
+    if (m_ledger[id].visitEpoch != epoch && !m_ledger[id].approvals.empty()) {
+      records.push_back(id);
+    }
+  }
+}
 
+void
+Peer::OnCatchUpInterest(const Interest& interest)
+{
+  const auto& interestName = interest.getName();
+
+  SyncState frontier;
+  if (!frontier.WireDecode(interestName.get(-2)) || !interestName.get(-1).isSegment()) {
+    NS_LOG_INFO("MALFORMED CATCHUP " << interestName);
+    return;
+  }
+  uint64_t segment = interestName.get(-1).toSegment();
+
+  Time now = Simulator::Now();
+  for (auto it = m_catchUpResponses.begin(); it != m_catchUpResponses.end(); ) {
+    if (it->second.expiry <= now) {
+      it = m_catchUpResponses.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  auto result = m_catchUpResponses.emplace(interestName.getPrefix(-1), CatchUpResponse());
+  auto& response = result.first->second;
+  if (result.second) {
+    std::vector<RecordId> records;
+    CollectCatchUpRecords(frontier, records);
+
+    // segments are cut at record boundaries; records pruned without a spill file are left to
+    // individual fetches from other peers
+    size_t currentSize = 0;
+    for (auto id : records) {
+      size_t size = GetRecordWireSize(id);
+      if (size == 0) {
+        continue;
+      }
+      if (response.segmentStarts.empty()
+          || (currentSize > 0 && currentSize + size > m_catchUpSegmentSize)) {
+        response.segmentStarts.push_back(response.records.size());
+        currentSize = 0;
+      }
+      currentSize += size;
+      response.records.push_back(id);
+    }
+    if (response.segmentStarts.empty()) {
+      response.segmentStarts.push_back(0);
+    }
+    response.expiry = now + m_catchUpCacheLifetime;
+  }
+
+  uint64_t lastSegment = response.segmentStarts.size() - 1;
+  if (segment > lastSegment) {
+    NS_LOG_INFO("NO CATCHUP segment " << interestName);
+    return;
+  }
+  size_t end = segment == lastSegment ? response.records.size()
+                                      : response.segmentStarts[segment + 1];
+
+  // a record pruned since the segments were cut leaves a gap, but does not shift the segments
+  Block content(::ndn::tlv::Content);
+  for (size_t i = response.segmentStarts[segment]; i != end; i++) {
+    auto record = LoadRecord(response.records[i]);
+    if (record != nullptr) {
+      content.push_back(record->wireEncode());
+    }
+  }
+  content.encode();
+
+  auto data = std::make_shared<Data>(interestName);
+  data->setContent(content);
+  data->setFinalBlockId(name::Component::fromSegment(lastSegment));
+  ndn::StackHelper::getKeyChain().sign(*data);
+
+  NS_LOG_INFO("> CATCHUP segment " << segment << "/" << lastSegment << " of "
+              << response.records.size());
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+void
+Peer::StartCatchUp(const name::Component& producer, const SyncState& frontier)
+{
+  m_catchUp = CatchUp();
+  m_catchUp.prefix = Name(m_mcPrefix).append(producer).append("CATCHUP");
+  m_catchUp.prefix.append(frontier.WireEncode());
+  m_catchUp.lastProgress = Simulator::Now();
+
+  NS_LOG_INFO("START CATCHUP " << m_catchUp.prefix);
+  m_catchUpsStarted++;
+  SendCatchUpSegments();
+  ScheduleFetchTimeout();
+}
+
+void
+Peer::SendCatchUpSegments()
+{
+  // the number of segments is learnt from the first one
+  uint64_t end = m_catchUp.isLastKnown ? m_catchUp.lastSegment + 1 : 1;
+  end = std::min<uint64_t>(end, m_catchUp.nextToAdmit + m_fetchWindow);
+
+  while (m_catchUp.nextSegment < end) {
+    SendCatchUpInterest(m_catchUp.nextSegment++);
+  }
+}
+
+void
+Peer::SendCatchUpInterest(uint64_t segment)
+{
+  auto interest = std::make_shared<Interest>(Name(m_catchUp.prefix).appendSegment(segment));
+  m_transmittedInterests(interest, this, m_face);
+  NS_LOG_INFO("> CATCHUP Interest " << interest->getName().toUri());
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+Peer::OnCatchUpSegment(shared_ptr<const Data> segment)
+{
+  const auto& segmentName = segment->getName();
+  if (segmentName.size() != m_catchUp.prefix.size() + 1 || !segmentName.get(-1).isSegment()) {
+    return;
+  }
+  uint64_t segmentNo = segmentName.get(-1).toSegment();
+  if (segmentNo < m_catchUp.nextToAdmit) {
+    return;
+  }
+
+  // the bundled ndn-cxx returns an empty component when there is no FinalBlockId
+  if (!m_catchUp.isLastKnown && segment->getFinalBlockId().isSegment()) {
+    m_catchUp.lastSegment = segment->getFinalBlockId().toSegment();
+    m_catchUp.isLastKnown = true;
+  }
+  m_catchUp.received[segmentNo] = segment;
+  m_catchUp.lastProgress = Simulator::Now();
+  m_catchUp.retxCount = 0;
+
+  // records of a segment may approve records of the previous segments only
+  while (!m_catchUp.received.empty()
+         && m_catchUp.received.begin()->first == m_catchUp.nextToAdmit) {
+    auto ready = m_catchUp.received.begin()->second;
+    m_catchUp.received.erase(m_catchUp.received.begin());
+    m_catchUp.nextToAdmit++;
+
+    try {
+      ready->getContent().parse();
+      for (const auto& wire : ready->getContent().elements()) {
+        auto record = std::make_shared<Data>(wire);
+        RecordDigest digest;
+        if (!Ledger::GetDigest(record->getName(), digest)) {
+          NS_LOG_INFO("Not a record name " << record->getName());
+          continue;
+        }
+        OnFetchSatisfied(digest, false);
+        ReceiveRecord(record, digest, CAUGHT_UP);
       }
-      std::set<std::string> visited;
-      UpdateWeightAndEntropy(record.block, visited, record.block->getName().getSubName(0, 2).toUri());
-      NS_LOG_INFO("ReceiveRecord: visited records size: " << visited.size()
-                  << " unconfirmed depth: " << log2(visited.size() + 1));
+    }
+    catch (const ::ndn::tlv::Error&) {
+      NS_LOG_INFO("MALFORMED CATCHUP segment " << ready->getName());
+    }
+  }
 
-      it = decltype(it)(m_recordStack.erase(std::next(it).base()));
+  if (m_catchUp.isLastKnown && m_catchUp.nextToAdmit > m_catchUp.lastSegment) {
+    NS_LOG_INFO("DONE CATCHUP " << m_catchUp.prefix);
+    if (m_catchUp.isFromCheckpoint) {
+      m_isBootstrapping = false;
     }
+    m_catchUp = CatchUp();
+    return;
   }
+  SendCatchUpSegments();
+}
+
+void
+Peer::SendCheckpointRequest()
+{
+  auto interest = std::make_shared<Interest>(Name(m_mcPrefix).append("CHECKPOINT"));
+  // a cached reply may be older than the latest checkpoint of the neighbors
+  interest->setMustBeFresh(true);
+  m_checkpointRequestTime = Simulator::Now();
+
+  NS_LOG_INFO("> CHECKPOINT Interest " << interest->getName().toUri());
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+  ScheduleFetchTimeout();
+}
+
+void
+Peer::OnCheckpointInterest(const Interest& interest)
+{
+  if (m_isBootstrapping || m_latestCheckpoint == INVALID_RECORD_ID) {
+    return;
+  }
+  auto checkpoint = LoadRecord(m_latestCheckpoint);
+  if (checkpoint == nullptr) {
+    return;
+  }
+
+  auto data = std::make_shared<Data>(interest.getName());
+  data->setContent(Block(::ndn::tlv::Content, checkpoint->wireEncode()));
+  ndn::StackHelper::getKeyChain().sign(*data);
+
+  NS_LOG_INFO("> CHECKPOINT " << checkpoint->getName());
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+void
+Peer::OnCheckpoint(shared_ptr<const Data> data)
+{
+  if (!m_isBootstrapping || !m_catchUp.prefix.empty()) {
+    return;
+  }
+
+  shared_ptr<const Data> record;
+  try {
+    record = std::make_shared<Data>(data->getContent().blockFromValue());
+  }
+  catch (const ::ndn::tlv::Error&) {
+    NS_LOG_INFO("MALFORMED CHECKPOINT reply");
+    return;
+  }
+
+  // a malformed reply is ignored, the request is retransmitted on timeout
+  RecordDigest digest;
+  RecordContent content;
+  Checkpoint checkpoint;
+  if (!Ledger::GetDigest(record->getName(), digest) || !content.WireDecode(record->getContent())
+      || content.payloadType != RecordContent::CHECKPOINT
+      || !checkpoint.WireDecode(content.payload)) {
+    NS_LOG_INFO("MALFORMED CHECKPOINT " << record->getName());
+    return;
+  }
+
+  // the joiner has no history to check the Merkle root against, so it trusts the neighbor that
+  // answers first; it only checks that the record is the one its name commits to
+  ::ndn::util::Sha256 sha;
+  sha.update(record->getContent().wire(), record->getContent().size());
+  auto contentDigest = sha.computeDigest();
+  if (!std::equal(digest.begin(), digest.end(), contentDigest->begin())) {
+    NS_LOG_INFO("CHECKPOINT DIGEST MISMATCH " << record->getName());
+    return;
+  }
+  NS_LOG_INFO("< CHECKPOINT " << record->getName());
+
+  // the checkpoint is archived by the neighbor, so it stands in for the history it approves;
+  // neither it nor the genesis records are tips any more
+  LedgerRecord anchor(record);
+  anchor.isCheckpoint = true;
+  anchor.hasHistoryGap = true;
+  auto anchorId = AdmitRecord(std::move(anchor), digest);
+  for (RecordId id = 0; id <= anchorId; id++) {
+    if (!m_ledger[id].isArchived) {
+      ArchiveRecord(id);
+    }
+    m_tips.Erase(id);
+  }
+
+  SyncState frontier;
+  frontier.AddTip(record->getName());
+  StartCatchUp(record->getName().get(1), frontier);
+  m_catchUp.isFromCheckpoint = true;
 }
 
 // Callback that will be called when Interest arrives
@@ -597,62 +1704,113 @@ void
 Peer::OnInterest(std::shared_ptr<const Interest> interest)
 {
   NS_LOG_INFO("< Interest " << interest->getName().toUri());
-  auto interestName = interest->getName();
-  auto interestNameUri = interestName.toUri();
+  const auto& interestName = interest->getName();
+
+  // the component after the multicast prefix tells the Interest kind
+  name::Component kind;
+  if (interestName.size() > m_mcPrefix.size()) {
+    kind = interestName.get(m_mcPrefix.size());
+  }
 
-  // if it is notification interest (/mc-prefix/NOTIF/creator-pref/name)
-  if (interestNameUri.find("NOTIF") != std::string::npos) {
+  // if it is checkpoint request (/mc-prefix/CHECKPOINT)
+  if (kind == name::Component("CHECKPOINT")) {
+    OnCheckpointInterest(*interest);
+  }
+  // records of a bootstrapping peer come with its checkpoint suffix
+  else if (m_isBootstrapping && (kind == name::Component("NOTIF")
+                                 || kind == name::Component("SYNC"))) {
+    return;
+  }
+  // else if it is notification interest (/mc-prefix/NOTIF/creator-pref/name[/record])
+  else if (kind == name::Component("NOTIF")) {
     Name recordName(m_mcPrefix);
-    recordName.append(interestName.getSubName(2).toUri());
-    FetchRecord(recordName);
-  }
-  // else if it is sync interest (/mc-prefix/SYNC/tip1/tip2 ...)
-  // note that here tip1 will be /mc-prefix/creator-pref/name)
-  else if (interestNameUri.find("SYNC") != std::string::npos) {
-    auto tipDigest = interestName.getSubName(2);
-    int iStartComponent = 0;
-    auto tipName = tipDigest.getSubName(iStartComponent, 3);
-    auto tipNameStr = tipName.toUri();
-    while (tipNameStr != "/") {
-      auto it = m_ledger.find(tipNameStr);
-      if (it == m_ledger.end()) {
-        FetchRecord(tipName);
+    recordName.append(interestName.getSubName(m_mcPrefix.size() + 1));
+    RecordDigest digest;
+    // a pushed record is no hex digest, so it is told apart by the last component
+    bool isPushed = false;
+    name::Component pushed;
+    if (!Ledger::GetDigest(recordName, digest) && recordName.size() > m_mcPrefix.size() + 1) {
+      isPushed = true;
+      pushed = recordName.get(-1);
+      recordName = recordName.getPrefix(-1);
+    }
+    if (!Ledger::GetDigest(recordName, digest)) {
+      NS_LOG_INFO("Not a record name " << recordName);
+      return;
+    }
+    m_notifReceived(this, digest, m_ledger.find(digest));
+
+    if (isPushed) {
+      shared_ptr<const Data> record;
+      try {
+        record = std::make_shared<Data>(Block(pushed.value(), pushed.value_size()));
       }
-      else {
-        // if weight is greater than 1,
-        // this node has more recent tips
-        // trigger sync
-        if (it->second.weight > 1) {
-          std::string syncNameStr(m_mcPrefix.toUri());
-          //Name syncName(m_mcPrefix);
-          //syncName.append("SYNC");
-          syncNameStr += "/SYNC";
-          for (size_t i = 0; i != m_tipList.size(); i++) {
-            //syncName.append(m_tipList[i]);
-            if(syncNameStr[syncNameStr.size() - 1] != '/' && m_tipList[i][0] != '/')
-              syncNameStr += "/";
-            syncNameStr += m_tipList[i];
-          }
-
-          auto syncInterest = std::make_shared<Interest>(syncNameStr);
-          m_transmittedInterests(syncInterest, this, m_face);
-          m_appLink->onReceiveInterest(*syncInterest);
-        }
+      catch (const ::ndn::tlv::Error&) {
+        NS_LOG_INFO("MALFORMED PUSHED RECORD");
+      }
+      if (record != nullptr && record->getName() == recordName) {
+        // a pushed record also completes a fetch started by SYNC, but is no RTT sample
+        OnFetchSatisfied(digest, false);
+        ReceiveRecord(record, digest, PUSHED);
+        return;
+      }
+    }
+    FetchRecord(recordName, digest);
+  }
+  // else if it is sync interest (/mc-prefix/SYNC/sync-state)
+  else if (kind == name::Component("SYNC")) {
+    SyncState state;
+    if (interestName.size() != m_mcPrefix.size() + 2 || !state.WireDecode(interestName.get(-1))) {
+      NS_LOG_INFO("MALFORMED SYNC STATE");
+      return;
+    }
+
+    bool hasStaleTip = false;
+    for (const auto& tip : state.tips) {
+      auto tipId = m_ledger.find(tip.digest);
+      if (tipId == INVALID_RECORD_ID) {
+        FetchRecord(GetRecordName(tip), tip.digest);
+      }
+      // if weight is greater than 1, this node has more recent tips
+      else if (m_ledger[tipId].weight > 1) {
+        hasStaleTip = true;
       }
-      iStartComponent += 3;
-      tipName = tipDigest.getSubName(iStartComponent, 3);
-      tipNameStr = tipName.toUri();
+    }
+
+    // one reply however many tips are stale, unless a SYNC as recent is heard first
+    if (hasStaleTip) {
+      ScheduleSyncReply(*interest);
+    }
+    else if (m_syncReplyEvent.IsRunning()) {
+      NS_LOG_INFO("SUPPRESS SYNC reply");
+      m_syncReplyEvent.Cancel();
+      m_syncRepliesSuppressed++;
     }
   }
+  // else if it is catch-up interest (/mc-prefix/producer/CATCHUP/sync-state/segment)
+  else if (interestName.size() == m_routablePrefix.size() + 3
+           && m_routablePrefix.isPrefixOf(interestName)
+           && interestName.get(m_routablePrefix.size()) == name::Component("CATCHUP")) {
+    OnCatchUpInterest(*interest);
+  }
   // else it is record fetching interest
   else {
-    auto it = m_ledger.find(interestName.toUri());
-    if (it != m_ledger.end()){
-      m_appLink->onReceiveData(*it->second.block);
+    RecordDigest digest;
+    if (!Ledger::GetDigest(interestName, digest)) {
+      NS_LOG_INFO("Not a record name " << interestName);
+      return;
     }
-    else {
+
+    auto recordId = m_ledger.find(digest);
+    if (recordId != INVALID_RECORD_ID){
+      auto record = LoadRecord(recordId);
+      if (record != nullptr) {
+        m_appLink->onReceiveData(*record);
+      }
+    }
+    else if (!m_isBootstrapping) {
       // This node doesn't have as well so it tries to fetch
-      FetchRecord(interestName);
+      FetchRecord(interestName, digest);
     }
   }
 }
@@ -3,29 +3,21 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/apps/ndn-consumer.hpp"
+#include "ns3/ndnSIM/apps/ndn-ledger.hpp"
+#include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
 
-#include <stack>
-#include <list>
+#include "ns3/traced-value.h"
+
+#include <deque>
+#include <fstream>
+#include <map>
+#include <unordered_set>
 
 namespace ns3 {
 namespace ndn {
 
-class LedgerRecord
-{
-public:
-  LedgerRecord(shared_ptr<const Data> contentObject,
-               int weight = 1, int entropy = 0, bool isArchived = false);
-public:
-  shared_ptr<const Data> block;
-  int weight = 1;
-  int entropy = 0;
-  std::set<std::string> approverNames;
-  bool isArchived = false;
-
-public:
-  bool isASample = false;
-  Time creationTime;
-};
+class SyncState;
+class Checkpoint;
 
 class Peer: public App
 {
@@ -37,6 +29,10 @@ public:
   Peer();
   virtual ~Peer(){};
 
+  typedef void (*WeightPropagationCallback)(Ptr<App> app, RecordId record, uint32_t nVisited, uint32_t depth);
+  typedef void (*ConfirmationCallback)(Ptr<App> app, RecordId record, Time latency);
+  typedef void (*RecordCallback)(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
   // (overridden from App) Callback that will be called when Data arrives
   virtual void
   OnData(shared_ptr<const Data> contentObject);
@@ -78,14 +74,40 @@ protected:
   GetSyncRandomize() const;
 
 public:
-  // Get approved blocks from record content
-  std::vector<std::string>
-  GetApprovedBlocks(shared_ptr<const Data> data);
+  // Name of a record of the ledger, pruned or not
+  Name
+  GetRecordName(RecordId recordId) const;
+
+  // Name of an approved record: /mc-prefix/producer/digest
+  Name
+  GetRecordName(const ApprovalEdge& approval) const;
 
   //Generates revocation record
   void
   GenerateRevocation(std::string revoked_node);
 
+  // Assigns fixed random variable streams, returns the number of streams used
+  int64_t
+  AssignStreams(int64_t stream);
+
+  // Most streams used by AssignStreams, to keep the streams of different peers apart
+  static const int64_t STREAMS_PER_PEER = 4;
+
+  // Number of admitted records that are not archived yet
+  uint32_t
+  GetUnconfirmedCount() const;
+
+  // Time since the oldest unconfirmed record was admitted
+  Time
+  GetOldestUnconfirmedAge() const;
+
+  // Counts of confirmation latencies (admission to archive), bin i covers [i, i+1) bin widths
+  const std::vector<uint32_t>&
+  GetConfirmationLatencyHistogram() const
+  {
+    return m_confirmationLatency;
+  }
+
 private:
 
   // Generates new record and sends notif interest
@@ -93,30 +115,177 @@ private:
   GenerateRecord();
 
   /// Helper functions for revocation and record generation ///
-  std::set<std::string> 
+  std::set<RecordId>
   SelectApprovals(bool revocation);
 
-  std::string 
-  BuildRecordContent(std::set<std::string> selectedBlocks, std::string specific_info);
+  Block
+  BuildRecordContent(const std::set<RecordId>& selectedBlocks, uint64_t payloadType,
+                     const std::string& payload);
 
   void 
-  GenerateRecordDataAndNotify(std::string recordContent, bool revocation);
+  GenerateRecordDataAndNotify(const std::set<RecordId>& selectedBlocks, const Block& recordContent,
+                              uint64_t payloadType);
+
+  // Summarizes the archived records: their frontier and the Merkle root over them;
+  // false if this peer lacks part of the history the root would cover
+  bool
+  BuildCheckpoint(Checkpoint& checkpoint);
+
+  // Outcome of a Merkle root computation over archived records
+  enum RootStatus {
+    ROOT_COMPUTED,
+    ROOT_UNKNOWN_FRONTIER, // a frontier record is not in the ledger
+    ROOT_HISTORY_GAP       // an ancestor of the frontier approves records the ledger never had
+  };
+
+  // Merkle root over the frontier and its ancestors
+  RootStatus
+  ComputeArchivedRoot(const std::vector<ApprovalEdge>& frontier, RecordDigest& root);
+
+  // Asks the neighbors for their latest archived checkpoint (/mc-prefix/CHECKPOINT)
+  void
+  SendCheckpointRequest();
+
+  // Answers a checkpoint request with the wire of the latest archived checkpoint record
+  void
+  OnCheckpointInterest(const Interest& interest);
+
+  // Starts the ledger of a joining peer from the checkpoint, then catches up with its suffix.
+  // The joiner trusts the first neighbor that answers: only the record digest is checked
+  void
+  OnCheckpoint(shared_ptr<const Data> data);
 
   // Adds revocation to blackList
   void
   AddRevocation(shared_ptr<const Data> data);
 
+  // Drops the pending records of a revoked producer, and the pending records approving them
+  void
+  EvictRevokedPending(const name::Component& producer);
+
   // Triggers sync interest
   void
   GenerateSync();
 
-  // Fetches record using the given prefix
+  // Multicasts a sync interest advertising the tips of this peer
+  void
+  SendSync();
+
+  // Schedules one reply to SYNCs advertising stale tips, after a delay growing with the distance
+  void
+  ScheduleSyncReply(const Interest& syncInterest);
+
+  void
+  SendSyncReply();
+
+  // Bounded sample of the tips of this peer
+  SyncState
+  BuildSyncState() const;
+
+  // Sync interest name carrying a bounded sample of tips: /mc-prefix/SYNC/sync-state
+  Name
+  BuildSyncName() const;
+
+  // Whether a tip may be approved by records generated on this peer
+  bool
+  IsEligibleTip(RecordId id) const;
+
+  // Queues a fetch of the record, unless it is known or already being fetched
+  void
+  FetchRecord(const Name& recordName, const RecordDigest& digest);
+
+  // Sends queued fetches while the in-flight window has room
+  void
+  SendFetches();
+
+  // Arms the timeout check, unless it is armed already
+  void
+  ScheduleFetchTimeout();
+
+  // Retransmits or gives up fetches whose RTO expired; checks again while any is left
+  void
+  CheckFetchTimeout();
+
+  // Completes the fetch of a record that arrived, sampling the RTT if it answers the fetch
+  void
+  OnFetchSatisfied(const RecordDigest& digest, bool isRttSample);
+
+  // How a record arrived
+  enum RecordSource {
+    FETCHED,  // in reply to a fetch
+    PUSHED,   // in its NOTIF
+    CAUGHT_UP // in a catch-up segment, as an ancestor of newer records
+  };
+
+  // Validates a record that arrived, then admits or buffers it
+  void
+  ReceiveRecord(shared_ptr<const Data> data, const RecordDigest& digest, RecordSource source);
+
+  // Records of the ledger that are not ancestors of the frontier, in topological order
+  void
+  CollectCatchUpRecords(const SyncState& frontier, std::vector<RecordId>& records);
+
+  // Answers a catch-up interest (/mc-prefix/producer/CATCHUP/sync-state/segment) with the
+  // segment of the records after the frontier, bundled whole in arena order
+  void
+  OnCatchUpInterest(const Interest& interest);
+
+  // Wire size of a record, 0 if it was pruned without a spill file
+  size_t
+  GetRecordWireSize(RecordId recordId) const;
+
+  // Fetches from the producer, in segments, the records after the frontier
+  void
+  StartCatchUp(const name::Component& producer, const SyncState& frontier);
+
+  // Requests catch-up segments while the window has room
+  void
+  SendCatchUpSegments();
+
+  void
+  SendCatchUpInterest(uint64_t segment);
+
+  // Admits the records of the catch-up segments that arrived in order
   void
-  FetchRecord(Name prefix);
+  OnCatchUpSegment(shared_ptr<const Data> segment);
+
+  // Attaches a record whose approvals are all in the ledger, updates tips and weights
+  RecordId
+  AdmitRecord(LedgerRecord record, const RecordDigest& digest);
+
+  // Resolves approvals of a record whose ancestors are all in the ledger and admits it
+  void
+  AcceptRecord(LedgerRecord record, const RecordDigest& digest);
+
+  // Admits a ready record, then every pending record that becomes ready, in topological order
+  void
+  AdmitWithDependents(LedgerRecord record, const RecordDigest& digest);
+
+  // Returns the ordinal of the producer, assigning the next one on first sight
+  uint32_t
+  GetProducerOrdinal(const name::Component& producer);
+
+  // Starts a new walk of the ledger, returns the stamp to compare with LedgerRecord::visitEpoch
+  uint32_t
+  NextVisitEpoch();
 
   // Update weight of records
   void
-  UpdateWeightAndEntropy(shared_ptr<const Data> tail, std::set<std::string>& visited, std::string nodeName);
+  UpdateWeightAndEntropy(RecordId tail, uint32_t approver);
+
+  // Releases the Data and the approvers of an archived record, after writing the Data to the
+  // spill file if there is one
+  void
+  PruneRecord(RecordId recordId);
+
+  // The Data of a record, read back from the spill file if the record is pruned;
+  // null if it was pruned without a spill file
+  shared_ptr<const Data>
+  LoadRecord(RecordId recordId);
+
+  // Marks record as archived and removes it from the unconfirmed list
+  void
+  ArchiveRecord(RecordId recordId);
 
 protected:
 
@@ -129,14 +298,124 @@ protected:
   EventId m_sendEvent; ///< @brief EventId of pending "send packet" event
   EventId m_syncSendEvent;
 
-  std::vector<std::string> m_tipList; // Tip list
-  std::map<std::string, LedgerRecord> m_ledger;
-
-  std::list<LedgerRecord> m_recordStack; // records stacked until their ancestors arrive
-  std::set<std::string> m_missingRecords;
+  TipSet m_tips; // Tip list
+  Ptr<UniformRandomVariable> m_tipRandom; // Samples tips to approve
+  Ledger m_ledger;
+
+  // records buffered until their ancestors arrive, with the number of ancestors still missing
+  struct PendingRecord
+  {
+    LedgerRecord record;
+    uint32_t nMissing;
+  };
+  std::unordered_map<RecordDigest, PendingRecord, RecordDigestHash> m_pendingRecords;
+  // missing record -> pending records that approve it
+  std::unordered_map<RecordDigest, std::vector<RecordDigest>, RecordDigestHash> m_waitingOn;
+  std::unordered_set<RecordDigest, RecordDigestHash> m_missingRecords;
   int m_reqCounter; // request counter that talies record fetching interests sent with data received back
+
+  uint32_t m_visitEpoch; // stamp of the current weight propagation, compared with LedgerRecord::visitEpoch
+  std::vector<std::pair<RecordId, uint32_t>> m_propagationStack; // (record, depth) pending expansion
+
+  TracedCallback<Ptr<App> /* app */, RecordId /* record */, uint32_t /* visited */, uint32_t /* depth */>
+    m_weightPropagation;
+
+  // record fetches, de-duplicated by digest across SYNC, NOTIF and ancestor triggers
+  struct FetchEntry
+  {
+    Name name;
+    Time sendTime;
+    uint32_t retxCount;
+    bool inFlight;
+  };
+  std::unordered_map<RecordDigest, FetchEntry, RecordDigestHash> m_fetches;
+  std::deque<RecordDigest> m_fetchQueue; // fetches waiting for room in the window
+  std::vector<RecordDigest> m_inFlightFetches;
+  Ptr<RttEstimator> m_fetchRtt;
+  EventId m_fetchRetxEvent;
+
+  TracedValue<uint32_t> m_fetchesIssued;
+  TracedValue<uint32_t> m_fetchesSatisfied;
+  TracedValue<uint32_t> m_fetchesDuplicated;
+  TracedValue<uint32_t> m_fetchesTimedOut;
+  TracedValue<uint32_t> m_recordsPushed;
+
+  // SYNC replies to stale tips, suppressed ChronoSync-style
+  EventId m_syncReplyEvent;
+  Ptr<UniformRandomVariable> m_syncReplyRandom;
+  TracedValue<uint32_t> m_syncsSent;
+  TracedValue<uint32_t> m_syncRepliesSent;
+  TracedValue<uint32_t> m_syncRepliesSuppressed;
+
+  // bulk catch-up of a lagging peer from one producer
+  struct CatchUp
+  {
+    Name prefix; // /mc-prefix/producer/CATCHUP/sync-state, empty if no catch-up is running
+    uint64_t nextSegment = 0; // next segment to request
+    uint64_t nextToAdmit = 0; // segments before are admitted
+    uint64_t lastSegment = 0;
+    bool isLastKnown = false; // the first segment carries the last segment number
+    std::map<uint64_t, shared_ptr<const Data>> received; // segments waiting for earlier ones
+    Time lastProgress;
+    uint32_t retxCount = 0;
+    bool isFromCheckpoint = false; // records approving unknown records build on the checkpoint
+  };
+  CatchUp m_catchUp;
+
+  // records after the frontier of a catch-up, cut into segments by its first interest, so that
+  // later segments neither walk the ledger again nor shift when records are pruned
+  struct CatchUpResponse
+  {
+    std::vector<RecordId> records;
+    std::vector<size_t> segmentStarts; // index of the first record of each segment
+    Time expiry;
+  };
+  std::map<Name, CatchUpResponse> m_catchUpResponses; // by /mc-prefix/producer/CATCHUP/sync-state
+
+  TracedValue<uint32_t> m_catchUpsStarted;
+  TracedValue<uint32_t> m_recordsCaughtUp;
+
+  // checkpoints, and bootstrap of a joining peer from the latest archived one
+  uint32_t m_archivedCount;
+  uint32_t m_lastCheckpointArchived; // m_archivedCount when this peer last made a checkpoint
+  RecordId m_latestCheckpoint;
+  bool m_isBootstrapping; // waiting for a checkpoint and its suffix, not generating
+  Time m_checkpointRequestTime;
+  uint32_t m_checkpointRequestRetx;
+  TracedValue<uint32_t> m_checkpointsGenerated;
+  TracedValue<uint32_t> m_checkpointsRejected;
+  TracedValue<uint32_t> m_checkpointsUnverified;
+
+  // pruning of deeply archived records
+  std::deque<RecordId> m_archivedQueue; // archived records not pruned yet, in archival order
+  std::fstream m_spillFile;
+  struct SpillEntry
+  {
+    uint64_t offset;
+    uint32_t size;
+  };
+  std::unordered_map<RecordId, SpillEntry> m_spillEntries;
+  TracedValue<uint32_t> m_recordsPruned;
+
+  // unconfirmed records, linked through LedgerRecord::prevUnconfirmed/nextUnconfirmed
+  RecordId m_unconfirmedHead;
+  RecordId m_unconfirmedTail;
+  TracedValue<uint32_t> m_unconfirmedCount;
+
+  Time m_latencyBinWidth; // bin width of the confirmation latency histogram
+  std::vector<uint32_t> m_confirmationLatency;
+  TracedCallback<Ptr<App> /* app */, RecordId /* record */, Time /* latency */> m_confirmed;
+
+  // record lifecycle, the record is INVALID_RECORD_ID until it is admitted
+  TracedCallback<Ptr<App>, const RecordDigest&, RecordId> m_recordGenerated;
+  TracedCallback<Ptr<App>, const RecordDigest&, RecordId> m_notifReceived;
+  TracedCallback<Ptr<App>, const RecordDigest&, RecordId> m_recordFetched;
+  TracedCallback<Ptr<App>, const RecordDigest&, RecordId> m_recordPushed;
+  TracedCallback<Ptr<App>, const RecordDigest&, RecordId> m_recordPending;
+  TracedCallback<Ptr<App>, const RecordDigest&, RecordId> m_recordAdmitted;
+  TracedCallback<Ptr<App>, const RecordDigest&, RecordId> m_recordArchived;
   
-  std::vector<std::string> m_blackList; // list of nodes whose certificates has been revoked
+  std::unordered_set<name::Component, NameComponentHash> m_blackList; // producers whose certificates has been revoked
 
   // the var to tune
   double m_frequency; // Frequency of record generation (in hertz)
@@ -146,18 +425,40 @@ protected:
   int m_entropyThreshold; // the number of peers to approve
   int m_genesisNum; // the number of genesis blocks
   int m_referredNum; // the number of referred blocks
+  uint32_t m_maxSyncTips; // max number of tips advertised by a sync interest
+  uint32_t m_fetchWindow; // max number of record fetches in flight
+  uint32_t m_maxFetchRetx; // retransmissions before a fetch is given up
+  Time m_fetchRetxTimer; // period of fetch timeout checks
+  uint32_t m_maxPushSize; // max wire size of a record carried in its NOTIF name, 0 disables pushing
+  Time m_syncReplyDelay; // back-off of a SYNC reply per hop from the stale peer
+  uint32_t m_catchUpThreshold; // pending records that start a catch-up, 0 disables catch-up
+  uint32_t m_catchUpSegmentSize; // max bytes of records bundled in a catch-up segment
+  Time m_catchUpCacheLifetime; // how long the segments of a catch-up are kept by the responder
+  uint32_t m_checkpointInterval; // records archived between checkpoints, 0 disables checkpoints
+  bool m_bootstrapFromCheckpoint; // join from the latest checkpoint instead of the genesis
+  uint32_t m_pruneDepth; // records archived after a record before it is pruned, 0 disables pruning
+  std::string m_spillFilePrefix; // pruned records are written to <prefix>-<node id>, if not empty
 
 private:
   Name m_routablePrefix; // Node's prefix
   Name m_mcPrefix; // Multicast prefix
   Name m_idManagerPrefix; // Identity Manager's Prefix
 
-  std::string m_lastRevocation; // to be used by identity manager
+  RecordId m_lastRevocation; // to be used by identity manager
+
+  // producers interned by ordinal, which indexes LedgerRecord::approvers
+  std::unordered_map<name::Component, uint32_t, NameComponentHash> m_producerOrdinals;
+  std::vector<name::Component> m_producers;
 
 public:
-  std::map<std::string, LedgerRecord> & GetLedger() {
+  const Ledger & GetLedger() const {
     return m_ledger;
   }
+
+  // Producer component of an ordinal found in LedgerRecord::approvers
+  const name::Component & GetProducer(uint32_t ordinal) const {
+    return m_producers[ordinal];
+  }
 };
 
 }
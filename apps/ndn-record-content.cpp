@@ -0,0 +1,279 @@
+#include "ndn-record-content.hpp"
+
+#include "../ndn-cxx/src/encoding/block-helpers.hpp"
+#include "../ndn-cxx/src/encoding/encoding-buffer.hpp"
+#include "../ndn-cxx/src/encoding/tlv.hpp"
+#include "../ndn-cxx/src/util/sha256.hpp"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+namespace tlv = ::ndn::tlv;
+
+// Splits /mc-prefix/producer/digest into an edge
+static bool
+MakeEdge(const Name& recordName, ApprovalEdge& edge)
+{
+  if (recordName.size() < 2 || !Ledger::GetDigest(recordName, edge.digest)) {
+    return false;
+  }
+  edge.producer = recordName.get(-2);
+  return true;
+}
+
+// Prepends count(VAR-NUMBER) (NameComponent 32*BYTE)* as the value of a TLV of the given type
+static size_t
+PrependDigestList(::ndn::EncodingBuffer& encoder, uint32_t type, const std::vector<ApprovalEdge>& edges)
+{
+  size_t length = 0;
+  for (auto it = edges.rbegin(); it != edges.rend(); ++it) {
+    length += encoder.prependByteArray(it->digest.data(), it->digest.size());
+    length += encoder.prependByteArray(it->producer.wire(), it->producer.size());
+  }
+  length += encoder.prependVarNumber(edges.size());
+
+  size_t totalLength = length;
+  totalLength += encoder.prependVarNumber(length);
+  totalLength += encoder.prependVarNumber(type);
+  return totalLength;
+}
+
+// Decodes the value of a digest list TLV, producer components share the block's buffer
+static bool
+DecodeDigestList(const Block& block, std::vector<ApprovalEdge>& edges)
+{
+  edges.clear();
+  auto it = block.value_begin();
+  auto end = block.value_end();
+  uint64_t count = 0;
+  if (!tlv::readVarNumber(it, end, count)) {
+    return false;
+  }
+  // every edge takes at least a component header and a digest
+  if (count > static_cast<uint64_t>(end - it) / (2 + sizeof(RecordDigest))) {
+    return false;
+  }
+  edges.reserve(count);
+  for (uint64_t i = 0; i != count; i++) {
+    auto componentBegin = it;
+    uint32_t type = 0;
+    uint64_t length = 0;
+    if (!tlv::readType(it, end, type) || type != tlv::NameComponent
+        || !tlv::readVarNumber(it, end, length)
+        || static_cast<uint64_t>(end - it) < length + sizeof(RecordDigest)) {
+      return false;
+    }
+    it += length;
+
+    ApprovalEdge edge;
+    edge.producer = name::Component(Block(block, componentBegin, it));
+    std::copy(it, it + edge.digest.size(), edge.digest.begin());
+    it += edge.digest.size();
+    edges.push_back(std::move(edge));
+  }
+  return it == end;
+}
+
+void
+RecordContent::AddApproval(const Name& recordName)
+{
+  ApprovalEdge edge;
+  if (MakeEdge(recordName, edge)) {
+    approvals.push_back(std::move(edge));
+  }
+}
+
+Block
+RecordContent::WireEncode() const
+{
+  ::ndn::EncodingBuffer encoder;
+  size_t totalLength = 0;
+
+  if (!payload.empty()) {
+    totalLength += encoder.prependByteArray(reinterpret_cast<const uint8_t*>(payload.data()),
+                                            payload.size());
+    totalLength += encoder.prependVarNumber(payload.size());
+    totalLength += encoder.prependVarNumber(tlv_dledger::Payload);
+  }
+  totalLength += ::ndn::encoding::prependNonNegativeIntegerBlock(encoder, tlv_dledger::PayloadType,
+                                                                 payloadType);
+
+  totalLength += PrependDigestList(encoder, tlv_dledger::Approvals, approvals);
+
+  totalLength += ::ndn::encoding::prependNonNegativeIntegerBlock(encoder, tlv_dledger::Version,
+                                                                 VERSION);
+
+  encoder.prependVarNumber(totalLength);
+  encoder.prependVarNumber(tlv::Content);
+  return encoder.block();
+}
+
+bool
+RecordContent::WireDecode(const Block& content)
+{
+  approvals.clear();
+  payloadType = APP_DATA;
+  payload.clear();
+
+  if (content.value_size() == 0) {
+    return true;
+  }
+
+  try {
+    content.parse();
+    auto element = content.elements_begin();
+    auto end = content.elements_end();
+
+    if (element == end || element->type() != tlv_dledger::Version
+        || ::ndn::encoding::readNonNegativeInteger(*element) != VERSION) {
+      return false;
+    }
+    ++element;
+
+    if (element == end || element->type() != tlv_dledger::Approvals) {
+      return false;
+    }
+    if (!DecodeDigestList(*element, approvals)) {
+      return false;
+    }
+    ++element;
+
+    if (element == end || element->type() != tlv_dledger::PayloadType) {
+      return false;
+    }
+    payloadType = ::ndn::encoding::readNonNegativeInteger(*element);
+    ++element;
+
+    if (element != end && element->type() == tlv_dledger::Payload) {
+      payload.assign(reinterpret_cast<const char*>(element->value()), element->value_size());
+    }
+  }
+  catch (const tlv::Error&) {
+    return false;
+  }
+  return true;
+}
+
+void
+SyncState::AddTip(const Name& recordName)
+{
+  ApprovalEdge edge;
+  if (MakeEdge(recordName, edge)) {
+    tips.push_back(std::move(edge));
+  }
+}
+
+name::Component
+SyncState::WireEncode() const
+{
+  ::ndn::EncodingBuffer encoder;
+  PrependDigestList(encoder, tlv_dledger::SyncState, tips);
+  Block state = encoder.block();
+  return name::Component(state.wire(), state.size());
+}
+
+bool
+SyncState::WireDecode(const name::Component& component)
+{
+  tips.clear();
+  try {
+    Block state(component.value(), component.value_size());
+    if (state.type() != tlv_dledger::SyncState) {
+      return false;
+    }
+    return DecodeDigestList(state, tips);
+  }
+  catch (const tlv::Error&) {
+    return false;
+  }
+}
+
+void
+Checkpoint::AddFrontier(const Name& recordName)
+{
+  ApprovalEdge edge;
+  if (MakeEdge(recordName, edge)) {
+    frontier.push_back(std::move(edge));
+  }
+}
+
+std::string
+Checkpoint::WireEncode() const
+{
+  ::ndn::EncodingBuffer encoder;
+  size_t totalLength = 0;
+
+  totalLength += encoder.prependByteArray(merkleRoot.data(), merkleRoot.size());
+  totalLength += encoder.prependVarNumber(merkleRoot.size());
+  totalLength += encoder.prependVarNumber(tlv_dledger::MerkleRoot);
+
+  totalLength += PrependDigestList(encoder, tlv_dledger::Frontier, frontier);
+
+  encoder.prependVarNumber(totalLength);
+  encoder.prependVarNumber(tlv_dledger::Checkpoint);
+  Block checkpoint = encoder.block();
+  return std::string(reinterpret_cast<const char*>(checkpoint.wire()), checkpoint.size());
+}
+
+bool
+Checkpoint::WireDecode(const std::string& payload)
+{
+  frontier.clear();
+  try {
+    Block checkpoint(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+    if (checkpoint.type() != tlv_dledger::Checkpoint) {
+      return false;
+    }
+    checkpoint.parse();
+    auto element = checkpoint.elements_begin();
+    auto end = checkpoint.elements_end();
+
+    if (element == end || element->type() != tlv_dledger::Frontier
+        || !DecodeDigestList(*element, frontier)) {
+      return false;
+    }
+    ++element;
+
+    if (element == end || element->type() != tlv_dledger::MerkleRoot
+        || element->value_size() != merkleRoot.size()) {
+      return false;
+    }
+    std::copy(element->value_begin(), element->value_end(), merkleRoot.begin());
+  }
+  catch (const tlv::Error&) {
+    return false;
+  }
+  return true;
+}
+
+RecordDigest
+Checkpoint::ComputeMerkleRoot(std::vector<RecordDigest> digests)
+{
+  RecordDigest root{};
+  if (digests.empty()) {
+    return root;
+  }
+
+  std::sort(digests.begin(), digests.end());
+  while (digests.size() > 1) {
+    size_t parents = 0;
+    for (size_t i = 0; i < digests.size(); i += 2) {
+      if (i + 1 == digests.size()) {
+        digests[parents++] = digests[i];
+        break;
+      }
+      ::ndn::util::Sha256 sha;
+      sha.update(digests[i].data(), digests[i].size());
+      sha.update(digests[i + 1].data(), digests[i + 1].size());
+      auto parent = sha.computeDigest();
+      std::copy(parent->begin(), parent->end(), digests[parents++].begin());
+    }
+    digests.resize(parents);
+  }
+  return digests.front();
+}
+
+}
+}
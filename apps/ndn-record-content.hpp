@@ -0,0 +1,132 @@
+#ifndef NDN_RECORD_CONTENT_H
+#define NDN_RECORD_CONTENT_H
+
+#include "ns3/ndnSIM/apps/ndn-ledger.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+namespace tlv_dledger {
+
+// TLV types of the DLedger record content, from the application-specific range
+enum {
+  Version     = 128,
+  Approvals   = 129,
+  PayloadType = 130,
+  Payload     = 131,
+  SyncState   = 132,
+  Checkpoint  = 133,
+  Frontier    = 134,
+  MerkleRoot  = 135
+};
+
+} // namespace tlv_dledger
+
+// Content of a DLedger record
+//
+//   Content      ::= CONTENT-TYPE TLV-LENGTH
+//                      Version
+//                      Approvals
+//                      PayloadType
+//                      Payload?
+//   Version      ::= VERSION-TYPE TLV-LENGTH nonNegativeInteger
+//   Approvals    ::= APPROVALS-TYPE TLV-LENGTH
+//                      count(VAR-NUMBER)
+//                      (NameComponent(producer) 32*BYTE(digest))*
+//   PayloadType  ::= PAYLOAD-TYPE-TYPE TLV-LENGTH nonNegativeInteger
+//   Payload      ::= PAYLOAD-TYPE TLV-LENGTH *BYTE
+//
+// Digests are fixed-width so approvals are decoded in one pass, and producer components
+// are decoded as sub-blocks sharing the Data wire buffer.
+class RecordContent
+{
+public:
+  static const uint64_t VERSION = 1;
+
+  enum PayloadKind {
+    APP_DATA = 0,
+    REVOCATION = 1,
+    CHECKPOINT = 2
+  };
+
+  // Appends an approval of the record named /mc-prefix/producer/digest
+  void
+  AddApproval(const Name& recordName);
+
+  Block
+  WireEncode() const;
+
+  // Decodes a record content block; an empty content (genesis) decodes to no approvals.
+  // Returns false if the block is malformed or has an unsupported version.
+  bool
+  WireDecode(const Block& content);
+
+public:
+  std::vector<ApprovalEdge> approvals;
+  uint64_t payloadType = APP_DATA;
+  std::string payload;
+};
+
+// Tips advertised by a SYNC Interest, carried as its last name component
+//
+//   SyncState    ::= SYNC-STATE-TYPE TLV-LENGTH
+//                      count(VAR-NUMBER)
+//                      (NameComponent(producer) 32*BYTE(digest))*
+//
+// The sender bounds the number of tips, so the Interest size does not grow with the DAG width.
+class SyncState
+{
+public:
+  void
+  AddTip(const Name& recordName);
+
+  name::Component
+  WireEncode() const;
+
+  bool
+  WireDecode(const name::Component& component);
+
+public:
+  std::vector<ApprovalEdge> tips;
+};
+
+// Payload of a checkpoint record, summarizing the archived part of its producer's ledger
+//
+//   Checkpoint   ::= CHECKPOINT-TYPE TLV-LENGTH
+//                      Frontier
+//                      MerkleRoot
+//   Frontier     ::= FRONTIER-TYPE TLV-LENGTH
+//                      count(VAR-NUMBER)
+//                      (NameComponent(producer) 32*BYTE(digest))*
+//   MerkleRoot   ::= MERKLE-ROOT-TYPE TLV-LENGTH 32*BYTE
+//
+// The frontier lists the archived records that no archived record approves.  The root covers
+// the frontier and all its ancestors, which every peer holding the frontier can recompute.
+class Checkpoint
+{
+public:
+  // Appends the record named /mc-prefix/producer/digest to the frontier
+  void
+  AddFrontier(const Name& recordName);
+
+  std::string
+  WireEncode() const;
+
+  // Returns false if the payload is malformed
+  bool
+  WireDecode(const std::string& payload);
+
+  // Root of the binary hash tree over the digests in ascending order; an odd node is carried
+  // up unchanged, and the root of no digest is all zeros
+  static RecordDigest
+  ComputeMerkleRoot(std::vector<RecordDigest> digests);
+
+public:
+  std::vector<ApprovalEdge> frontier;
+  RecordDigest merkleRoot{};
+};
+
+}
+}
+
+#endif
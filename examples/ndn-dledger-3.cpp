@@ -15,6 +15,7 @@ using namespace ns3;
 using ns3::ndn::StackHelper;
 using ns3::ndn::AppHelper;
 using ns3::ndn::L3RateTracer;
+using ns3::ndn::PeerTracer;
 using ns3::ndn::FibHelper;
 using ns3::ndn::StrategyChoiceHelper;
 using ns3::ndn::GlobalRoutingHelper;
@@ -40,7 +41,7 @@ upLink(Ptr<NetDevice> nd)
 void
 inspectRecords()
 {
-  map<std::string, std::string> namemap;
+  vector<std::string> namemap;
 
   for(auto node = NodeList::Begin(); node != NodeList::End(); ++ node) {
     auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
@@ -51,17 +52,17 @@ inspectRecords()
     cout << "digraph{" << endl;
 
     namemap.clear();
-    int cnt = 0;
-    for(auto & it : ledger){
-      namemap[it.first] = it.first.substr(9, 16);
+    // pruned records have no Data left, the peer still knows their names
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      namemap.push_back(peer->GetRecordName(id).toUri().substr(9, 16));
     }
 
-    for(auto & it : ledger) {
-      cout << "\"" << namemap[it.first] << "\"";
-      if(it.second.approverNames.size() > 0){
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      cout << "\"" << namemap[id] << "\"";
+      if(ledger[id].approvers.size() > 0){
         cout << " -> {";
-        for(auto & approver : it.second.approverNames) {
-          cout << " \"" << namemap[approver] << "\"";
+        for(auto approver : ledger[id].approvers.GetOrdinals()) {
+          cout << " \"" << peer->GetProducer(approver) << "\"";
         }
         cout << " }";
       }
@@ -92,12 +93,7 @@ showProgress(){
 
   auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
   auto & ledger = peer->GetLedger();
-  int unconfirmedCnt = 0;
-  for(const auto & record : ledger){
-    if (record.second.isArchived == false) { // EntropyThreshold -> confirm
-      unconfirmedCnt ++;
-    }
-  }
+  int unconfirmedCnt = peer->GetUnconfirmedCount(); // maintained incrementally by the peer
   std::cout << " " << ledger.size();
   std::cout << " " << unconfirmedCnt;
   std::cout << std::endl;
@@ -185,6 +181,8 @@ main(int argc, char *argv[])
   start_time = std::chrono::steady_clock::now();
   std::cout << "simulation-time real-time total unconfirmed" << std::endl;
 
+  PeerTracer::InstallAll("peer-trace.txt");
+
   Simulator::Run();
 
   // auto end_time = std::chrono::steady_clock::now();
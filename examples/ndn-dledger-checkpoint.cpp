@@ -0,0 +1,121 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include <iostream>
+
+using namespace std;
+using namespace ns3;
+
+using ns3::ndn::StackHelper;
+using ns3::ndn::AppHelper;
+using ns3::ndn::StrategyChoiceHelper;
+using ns3::ndn::GlobalRoutingHelper;
+using ns3::ndn::RecordDigest;
+using ns3::ndn::RecordId;
+
+NS_LOG_COMPONENT_DEFINE ("ndn.dledger.checkpoint");
+
+// Time to first generation of a peer joining a running ledger:
+//
+//     ./waf --run "ndn-dledger-checkpoint --records=10000 --checkpoint=1"
+//     ./waf --run "ndn-dledger-checkpoint --records=10000 --checkpoint=0"
+//
+// The other peers generate records until the ledger holds about the given number, then the
+// last node joins, from the latest checkpoint or from the genesis records.
+
+static Time g_joinTime;
+static Time g_firstGeneration;
+
+void
+recordGenerated(Ptr<ndn::App> app, const RecordDigest& digest, RecordId record)
+{
+  if (g_firstGeneration.IsZero()) {
+    g_firstGeneration = Simulator::Now();
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  // setting default parameters for PointToPoint links and channels
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+  Config::SetDefault("ns3::QueueBase::MaxSize",
+                     QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, 20)));
+
+  int node_num = 20;
+  int records = 10000;
+  double frequency = 5;
+  int checkpointInterval = 500;
+  bool checkpoint = true;
+
+  CommandLine cmd;
+  cmd.AddValue("nodes", "Number of peers, the last one joins late", node_num);
+  cmd.AddValue("records", "Records in the ledger when the last peer joins", records);
+  cmd.AddValue("frequency", "Records generated per second by each peer", frequency);
+  cmd.AddValue("interval", "Records archived between checkpoints", checkpointInterval);
+  cmd.AddValue("checkpoint", "Whether the last peer joins from a checkpoint", checkpoint);
+  cmd.Parse(argc, argv);
+
+  // Creating nodes
+  NodeContainer nodes;
+  nodes.Create(node_num);
+
+  PointToPointHelper p2p;
+  for (int i = 0; i < node_num - 1; i++) {
+    p2p.Install(nodes.Get(i), nodes.Get(i + 1));
+  }
+
+  // Install NDN stack on all nodes
+  StackHelper ndnHelper;
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.InstallAll();
+
+  StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/multicast");
+
+  GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+
+  g_joinTime = Seconds(2 + records / (frequency * (node_num - 1)));
+
+  for (int i = 0; i < node_num; i++) {
+    Ptr<Node> object = nodes.Get(i);
+    bool isJoining = i == node_num - 1;
+
+    std::string prefix = "/dledger/node" + std::to_string(i);
+    AppHelper peerHelper("Peer");
+    peerHelper.SetAttribute("Routable-Prefix", StringValue(prefix));
+    peerHelper.SetAttribute("Multicast-Prefix", StringValue("/dledger"));
+    peerHelper.SetAttribute("Frequency", DoubleValue(frequency));
+    peerHelper.SetAttribute("GenesisNum", IntegerValue(5));
+    peerHelper.SetAttribute("ReferredNum", IntegerValue(2));
+    peerHelper.SetAttribute("CheckpointInterval", UintegerValue(checkpointInterval));
+    peerHelper.SetAttribute("BootstrapFromCheckpoint", BooleanValue(isJoining && checkpoint));
+
+    peerHelper.Install(object).Start(isJoining ? g_joinTime : Seconds(2));
+
+    ndnGlobalRoutingHelper.AddOrigins(prefix, object);
+    ndnGlobalRoutingHelper.AddOrigins("/dledger", object);
+  }
+
+  GlobalRoutingHelper::CalculateRoutes();
+
+  Config::ConnectWithoutContext("/NodeList/" + std::to_string(nodes.Get(node_num - 1)->GetId())
+                                + "/ApplicationList/*/RecordGenerated",
+                                MakeCallback(&recordGenerated));
+
+  Simulator::Stop(g_joinTime + Seconds(60.0));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  if (g_firstGeneration.IsZero()) {
+    std::cout << "No record generated within 60s of joining at " << g_joinTime.GetSeconds()
+              << "s" << std::endl;
+    return 1;
+  }
+  std::cout << "Joined at " << g_joinTime.GetSeconds() << "s, first record after "
+            << (g_firstGeneration - g_joinTime).GetSeconds() << "s" << std::endl;
+  return 0;
+}
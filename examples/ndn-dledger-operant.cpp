@@ -15,6 +15,7 @@ using namespace ns3;
 using ns3::ndn::StackHelper;
 using ns3::ndn::AppHelper;
 using ns3::ndn::L3RateTracer;
+using ns3::ndn::PeerTracer;
 using ns3::ndn::FibHelper;
 using ns3::ndn::StrategyChoiceHelper;
 using ns3::ndn::GlobalRoutingHelper;
@@ -28,7 +29,7 @@ const double TotalTime = 30.0;
 void
 inspectRecords()
 {
-  map<std::string, std::string> namemap;
+  vector<std::string> namemap;
 
   for(auto node = NodeList::Begin(); node != NodeList::End(); ++ node) {
     if((*node)->GetNApplications() == 0)
@@ -41,15 +42,14 @@ inspectRecords()
     cout << "digraph{" << endl;
 
     namemap.clear();
-    int cnt = 0;
-    for(auto & it : ledger){
-      namemap[it.first] = it.first.substr(9, 16);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      namemap.push_back(peer->GetRecordName(id).toUri().substr(9, 16));
     }
 
-    for(auto & it : ledger) {
-      auto approvees = peer->GetApprovedBlocks(it.second.block);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      const auto & approvees = ledger[id].approvals;
 
-      cout << "\"" << namemap[it.first] << "\"";
+      cout << "\"" << namemap[id] << "\"";
 
       if(approvees.size() > 0){
         cout << " -> {";
@@ -60,10 +60,10 @@ inspectRecords()
       }
 
 
-      // if(it.second.approverNames.size() > 0){
+      // if(ledger[id].approvers.size() > 0){
       //   cout << " -> {";
-      //   for(auto & approver : it.second.approverNames) {
-      //     cout << " \"" << namemap[approver] << "\"";
+      //   for(auto approver : ledger[id].approvers.GetOrdinals()) {
+      //     cout << " \"" << peer->GetProducer(approver) << "\"";
       //   }
       //   cout << " }";
       // }
@@ -156,6 +156,8 @@ main(int argc, char *argv[])
   Simulator::Schedule(Seconds(TotalTime - 0.1), inspectRecords);
   Simulator::Stop(Seconds(TotalTime));
 
+  PeerTracer::InstallAll("peer-trace.txt");
+
   Simulator::Run();
   Simulator::Destroy ();
   return 0;
@@ -8,6 +8,7 @@
 #include "ns3/ndnSIM/apps/ndn-peer.hpp"
 #include <map>
 #include <chrono>
+#include <fstream>
 
 using namespace std;
 using namespace ns3;
@@ -15,9 +16,11 @@ using namespace ns3;
 using ns3::ndn::StackHelper;
 using ns3::ndn::AppHelper;
 using ns3::ndn::L3RateTracer;
+using ns3::ndn::PeerTracer;
 using ns3::ndn::FibHelper;
 using ns3::ndn::StrategyChoiceHelper;
 using ns3::ndn::GlobalRoutingHelper;
+using ns3::ndn::LinkControlHelper;
 
 NS_LOG_COMPONENT_DEFINE ("ndn.dledger");
 
@@ -26,68 +29,53 @@ const int EntropyThreshold = 8;
 const int MaxEntropy = 5;
 const double TotalTime = 100.0;
 
-void
-failLink(Ptr<NetDevice> nd)
-{
-  Ptr<RateErrorModel> error = CreateObject<RateErrorModel> ();
-  error->SetAttribute ("ErrorRate", DoubleValue (1.0));
-  nd->SetAttribute ("ReceiveErrorModel", PointerValue(error));
-}
+// ledger snapshots and progress, kept apart from the simulation log on stdout
+std::ofstream g_output;
 
-void
-upLink(Ptr<NetDevice> nd)
-{
-  Ptr<RateErrorModel> error = CreateObject<RateErrorModel> ();
-  error->SetAttribute ("ErrorRate", DoubleValue (-0.1));
-  nd->SetAttribute ("ReceiveErrorModel", PointerValue(error));
-}
-
-// TODO: THE RESULTS INTERWAVES; USE FILE TO OUTPUT.
 void
 inspectRecords()
 {
-  map<std::string, std::string> namemap;
+  vector<std::string> namemap;
 
   for(auto node = NodeList::Begin(); node != NodeList::End(); ++ node) {
     if((*node)->GetNApplications() == 0)
       continue;
     auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
     auto & ledger = peer->GetLedger();
-    cout << "================================================" << endl;
-    cout << "TIME: " << Simulator::Now() << endl;
-    cout << "Node Id: " << (*node)->GetId() << " Ledger Size: " << ledger.size() << endl;
-    cout << "digraph{" << endl;
+    g_output << "================================================" << endl;
+    g_output << "TIME: " << Simulator::Now() << endl;
+    g_output << "Node Id: " << (*node)->GetId() << " Ledger Size: " << ledger.size() << endl;
+    g_output << "digraph{" << endl;
 
     namemap.clear();
-    int cnt = 0;
-    for(auto & it : ledger){
-      namemap[it.first] = it.first.substr(9, 16);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      namemap.push_back(peer->GetRecordName(id).toUri().substr(9, 16));
     }
 
-    for(auto & it : ledger) {
-      auto approvees = peer->GetApprovedBlocks(it.second.block);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      const auto & approvees = ledger[id].approvals;
 
-      cout << "\"" << namemap[it.first] << "\"";
+      g_output << "\"" << namemap[id] << "\"";
 
       if(approvees.size() > 0){
-        cout << " -> {";
+        g_output << " -> {";
         for(const auto & approvee : approvees){
-          cout << " \"" << namemap[approvee] << "\"";
+          g_output << " \"" << namemap[approvee] << "\"";
         }
-        cout << " }";
+        g_output << " }";
       }
 
 
-      // if(it.second.approverNames.size() > 0){
-      //   cout << " -> {";
-      //   for(auto & approver : it.second.approverNames) {
-      //     cout << " \"" << namemap[approver] << "\"";
+      // if(ledger[id].approvers.size() > 0){
+      //   g_output << " -> {";
+      //   for(auto approver : ledger[id].approvers.GetOrdinals()) {
+      //     g_output << " \"" << peer->GetProducer(approver) << "\"";
       //   }
-      //   cout << " }";
+      //   g_output << " }";
       // }
-      cout << endl;
+      g_output << endl;
     }
-    cout << "}" << endl;
+    g_output << "}" << endl;
 
     //break;
   }
@@ -100,10 +88,10 @@ void
 showProgress(){
   auto end_time = std::chrono::steady_clock::now();
   static int progress = 0;
-  std::cout << ++ progress << "% "
-            << std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count()
-            << "sec";
-            //<< std::endl;
+  g_output << ++ progress << "% "
+           << std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count()
+           << "sec";
+           //<< std::endl;
 
   auto node = NodeList::Begin();
   for(; node != NodeList::End(); ++ node) {
@@ -114,15 +102,10 @@ showProgress(){
 
   auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
   auto & ledger = peer->GetLedger();
-  int unconfirmedCnt = 0;
-  for(const auto & record : ledger){
-    if(record.second.entropy < EntropyThreshold) { // EntropyThreshold -> confirm
-      unconfirmedCnt ++;
-    }
-  }
-  std::cout << " Total Count=" << ledger.size();
-  std::cout << " Unconfirmed Count=" << unconfirmedCnt;
-  std::cout << std::endl;
+  int unconfirmedCnt = peer->GetUnconfirmedCount(); // maintained incrementally by the peer
+  g_output << " Total Count=" << ledger.size();
+  g_output << " Unconfirmed Count=" << unconfirmedCnt;
+  g_output << std::endl;
 
   Simulator::Schedule(Seconds(1.0), showProgress);
 }
@@ -140,6 +123,8 @@ main(int argc, char *argv[])
   CommandLine cmd;
   cmd.Parse(argc, argv);
 
+  g_output.open("dledger-output.txt");
+
   // Creating nodes
   int node_num = NodesCnt;
   NodeContainer nodes;
@@ -189,16 +174,19 @@ main(int argc, char *argv[])
     counter++;
   }
 
-  // Calculate and install FIBs
+  // Calculate and install FIBs, keeping the shortest path trees to patch them on link changes
+  GlobalRoutingHelper::SetIncrementalRouting(true);
   GlobalRoutingHelper::CalculateRoutes();
 
   // Finish Installation****************************************************
-  Simulator::Schedule(Seconds(20.0), failLink, nodes.Get(7)->GetDevice(0));
-  Simulator::Schedule(Seconds(80.0), upLink, nodes.Get(7)->GetDevice(0));
+  Simulator::Schedule(Seconds(20.0), LinkControlHelper::FailLink, nodes.Get(6), nodes.Get(7));
+  Simulator::Schedule(Seconds(80.0), LinkControlHelper::UpLink, nodes.Get(6), nodes.Get(7));
 
   Simulator::Schedule(Seconds(TotalTime - 0.1), inspectRecords);
   Simulator::Stop(Seconds(TotalTime));
 
+  PeerTracer::InstallAll("peer-trace.txt");
+
   start_time = std::chrono::steady_clock::now();
 
   Simulator::Run();
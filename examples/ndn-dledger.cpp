@@ -13,6 +13,7 @@ using namespace ns3;
 using ns3::ndn::StackHelper;
 using ns3::ndn::AppHelper;
 using ns3::ndn::L3RateTracer;
+using ns3::ndn::PeerTracer;
 using ns3::ndn::FibHelper;
 using ns3::ndn::StrategyChoiceHelper;
 using ns3::ndn::GlobalRoutingHelper;
@@ -98,6 +99,8 @@ main(int argc, char *argv[])
   Simulator::Schedule(Seconds(5.0), failLink, nodes.Get(51)->GetDevice(0));
   Simulator::Stop(Seconds (100.0));
 
+  PeerTracer::InstallAll("peer-trace.txt");
+
   Simulator::Run();
   Simulator::Destroy ();
 
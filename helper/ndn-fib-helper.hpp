@@ -39,7 +39,8 @@ using ::ndn::nfd::ControlParameters;
  *
  * The FIB helper interacts with the FIB manager of NFD by sending special Interest
  * commands to the manager in order to add/remove a next hop from FIB entries or add
- * routes to the FIB manually (manual configuration of FIB).
+ * routes to the FIB manually (manual configuration of FIB).  On a forwarding-only stack
+ * (StackHelper::setForwardingOnly), which has no FIB manager, the FIB is modified directly.
  */
 class FibHelper {
 public:
@@ -46,12 +46,20 @@
 #include "ns3/node-list.h"
 #include "ns3/channel-list.h"
 #include "ns3/object-factory.h"
+#include "ns3/simulator.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
 #include <boost/concept/assert.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
-
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <thread>
 #include <unordered_map>
 
 #include "boost-graph-ndn-global-routing-helper.hpp"
@@ -214,67 +222,447 @@ GlobalRoutingHelper::AddOriginsForAll()
   }
 }
 
+namespace {
+
+const uint32_t NO_FACE = std::numeric_limits<uint32_t>::max();
+
+// metric of a face disabled while calculating all possible routes;
+// std::numeric_limits<uint16_t>::max () MUST NOT be used (reserved)
+const uint16_t DISABLED_METRIC = std::numeric_limits<uint16_t>::max() - 1;
+
+uint32_t g_routeCalculationThreads = 0;
+
+// Distance of a route: first-hop face (index into RouteGraph::faces) and accumulated metric.
+// Mirrors the (face, metric, delay) tuples of the boost::NdnGlobalRouterGraph property maps.
+struct RouteDistance
+{
+  uint32_t face;
+  uint32_t metric;
+};
+
+const RouteDistance DISTANCE_ZERO = {NO_FACE, 0};
+const RouteDistance DISTANCE_INF = {NO_FACE, std::numeric_limits<uint16_t>::max()};
+
+struct RouteDistanceCompare
+{
+  bool
+  operator()(const RouteDistance& a, const RouteDistance& b) const
+  {
+    return a.metric < b.metric;
+  }
+};
+
+struct RouteDistanceCombine
+{
+  RouteDistance
+  operator()(const RouteDistance& a, const RouteDistance& b) const
+  {
+    return {a.face == NO_FACE ? b.face : a.face, a.metric + b.metric};
+  }
+};
+
+// Snapshot of the GlobalRouter graph in CSR form.  Vertices and out-edges keep the order of
+// boost::NdnGlobalRouterGraph, so Dijkstra relaxes edges in the same order and breaks ties in
+// the same way as on the live graph.  Only edge weights change after construction, when
+// incremental routing takes a link down or up.
+struct RouteGraph
+{
+  typedef boost::compressed_sparse_row_graph<boost::directedS> Csr;
+
+  RouteGraph()
+  {
+    boost::NdnGlobalRouterGraph liveGraph;
+    for (const auto& router : liveGraph.GetVertices()) {
+      vertexIndex[PeekPointer(router)] = routers.size();
+      routers.push_back(router);
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t vertex = 0; vertex < routers.size(); ++vertex) {
+      for (const auto& incidency : routers[vertex]->GetIncidencies()) {
+        edges.push_back(std::make_pair(vertex, vertexIndex.at(PeekPointer(std::get<2>(incidency)))));
+
+        const auto& face = std::get<1>(incidency);
+        if (face == nullptr) {
+          weights.push_back(DISTANCE_ZERO);
+          continue;
+        }
+        auto result = faceIndex.insert(std::make_pair(face.get(), faces.size()));
+        if (result.second) {
+          faces.push_back(face);
+          faceOwners.push_back(vertex);
+        }
+        weights.push_back({result.first->second, static_cast<uint16_t>(face->getMetric())});
+      }
+    }
+    // edges are generated in source order, so CSR keeps their order and edge index
+    csr = Csr(boost::edges_are_sorted, edges.begin(), edges.end(), routers.size());
+
+    // DistancesMap was ordered by Ptr<GlobalRouter>, which sets the order of route installation
+    destinationOrder.resize(routers.size());
+    for (uint32_t vertex = 0; vertex < routers.size(); ++vertex) {
+      destinationOrder[vertex] = vertex;
+    }
+    std::sort(destinationOrder.begin(), destinationOrder.end(), [this] (uint32_t a, uint32_t b) {
+        return std::less<GlobalRouter*>()(PeekPointer(routers[a]), PeekPointer(routers[b]));
+      });
+  }
+
+  void
+  ShortestPaths(uint32_t source, const std::vector<RouteDistance>& edgeWeights,
+                std::vector<RouteDistance>& distances) const
+  {
+    distances.assign(routers.size(), DISTANCE_INF);
+    boost::dijkstra_shortest_paths(csr, source,
+                                   boost::weight_map(boost::make_iterator_property_map(
+                                                       edgeWeights.begin(),
+                                                       boost::get(boost::edge_index, csr)))
+                                     .distance_map(boost::make_iterator_property_map(
+                                                     distances.begin(),
+                                                     boost::get(boost::vertex_index, csr)))
+                                     .distance_inf(DISTANCE_INF)
+                                     .distance_zero(DISTANCE_ZERO)
+                                     .distance_compare(RouteDistanceCompare())
+                                     .distance_combine(RouteDistanceCombine()));
+  }
+
+  std::vector<Ptr<GlobalRouter>> routers;
+  std::unordered_map<GlobalRouter*, uint32_t> vertexIndex;
+  std::vector<shared_ptr<Face>> faces;
+  std::unordered_map<const Face*, uint32_t> faceIndex;
+  std::vector<uint32_t> faceOwners; // vertex whose out-edges use the face
+  std::vector<RouteDistance> weights; // indexed by edge index
+  std::vector<uint32_t> destinationOrder;
+  Csr csr;
+};
+
+// Shortest path trees kept by CalculateRoutes in incremental mode
+struct IncrementalRoutingState
+{
+  RouteGraph graph;
+  std::vector<std::vector<RouteDistance>> distances; // by source vertex; empty for non-sources
+
+  // origins of every prefix, in route installation order
+  std::map<Name, std::vector<uint32_t>> origins;
+};
+
+bool g_isIncrementalRouting = false;
+shared_ptr<IncrementalRoutingState> g_incrementalState;
+
+// links taken down while in incremental mode, by pair of node IDs (lower ID first)
+std::set<std::pair<uint32_t, uint32_t>> g_downLinks;
+
+// incremental mode lasts until it is disabled or the simulator is destroyed
+void
+resetIncrementalRouting()
+{
+  g_isIncrementalRouting = false;
+  g_incrementalState.reset();
+  g_downLinks.clear();
+}
+
+std::pair<uint32_t, uint32_t>
+makeLinkKey(Ptr<Node> node1, Ptr<Node> node2)
+{
+  uint32_t id1 = node1->GetId();
+  uint32_t id2 = node2->GetId();
+  return std::make_pair(std::min(id1, id2), std::max(id1, id2));
+}
+
+struct EdgeChange
+{
+  size_t index;
+  uint32_t from;
+  uint32_t to;
+  RouteDistance oldWeight;
+};
+
+// Sets the weight of the edges between two vertices according to the link state, and returns
+// the edges that changed
+std::vector<EdgeChange>
+setLinkState(RouteGraph& graph, uint32_t vertex1, uint32_t vertex2, bool isUp)
+{
+  std::vector<EdgeChange> changed;
+  for (auto ends : {std::make_pair(vertex1, vertex2), std::make_pair(vertex2, vertex1)}) {
+    auto edges = boost::out_edges(RouteGraph::Csr::vertex_descriptor(ends.first), graph.csr);
+    for (auto edge = edges.first; edge != edges.second; ++edge) {
+      if (boost::target(*edge, graph.csr) != ends.second) {
+        continue;
+      }
+      size_t index = boost::get(boost::edge_index, graph.csr, *edge);
+      RouteDistance weight = graph.weights[index];
+      if (isUp) {
+        weight.metric = weight.face == NO_FACE ? 0 : static_cast<uint16_t>(graph.faces[weight.face]->getMetric());
+      }
+      else {
+        // an infinite edge never relaxes a distance
+        weight.metric = DISTANCE_INF.metric;
+      }
+      if (weight.metric != graph.weights[index].metric) {
+        changed.push_back({index, ends.first, ends.second, graph.weights[index]});
+        graph.weights[index] = weight;
+      }
+    }
+  }
+  return changed;
+}
+
+// Next hops that CalculateRoutes installs for the prefix on the source: AddRoute is called for
+// every origin in order, so the cost of a face is that of the last origin reached through it
+std::map<uint32_t, uint32_t>
+getNextHops(const std::vector<RouteDistance>& distances, uint32_t source,
+            const std::vector<uint32_t>& origins)
+{
+  std::map<uint32_t, uint32_t> nextHops;
+  for (uint32_t origin : origins) {
+    if (origin != source && distances[origin].face != NO_FACE) {
+      nextHops[distances[origin].face] = distances[origin].metric;
+    }
+  }
+  return nextHops;
+}
+
+uint32_t
+getRouteCalculationThreads()
+{
+  if (g_routeCalculationThreads != 0) {
+    return g_routeCalculationThreads;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs task(worker, i) for every i in [0, nTasks) on nThreads threads
+template<class Task>
+void
+parallelFor(size_t nTasks, uint32_t nThreads, const Task& task)
+{
+  nThreads = std::min<size_t>(nThreads, nTasks);
+  if (nThreads <= 1) {
+    for (size_t i = 0; i < nTasks; ++i) {
+      task(0, i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> threads;
+  for (uint32_t worker = 0; worker < nThreads; ++worker) {
+    threads.emplace_back([&, worker] {
+        for (size_t i = next++; i < nTasks; i = next++) {
+          task(worker, i);
+        }
+      });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Number of shortest path trees kept in memory per thread before their routes are installed
+const size_t BATCH_PER_THREAD = 8;
+
+} // namespace
+
+void
+GlobalRoutingHelper::SetRouteCalculationThreads(uint32_t nThreads)
+{
+  g_routeCalculationThreads = nThreads;
+}
+
 void
 GlobalRoutingHelper::CalculateRoutes()
 {
   /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   * Shortest path trees are computed with Boost Graph Library's Dijkstra on an immutable CSR
+   * snapshot of the GlobalRouter graph, one source per task on a pool of threads.  Routes are
+   * then installed serially, in the same order as a sequential calculation would install them.
    */
 
-  BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
-  BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
+  auto state = make_shared<IncrementalRoutingState>();
+  RouteGraph& graph = state->graph;
+  if (g_isIncrementalRouting) {
+    for (const auto& link : g_downLinks) {
+      Ptr<GlobalRouter> router1 = NodeList::GetNode(link.first)->GetObject<GlobalRouter>();
+      Ptr<GlobalRouter> router2 = NodeList::GetNode(link.second)->GetObject<GlobalRouter>();
+      setLinkState(graph, graph.vertexIndex.at(PeekPointer(router1)),
+                   graph.vertexIndex.at(PeekPointer(router2)), false);
+    }
+    state->distances.resize(graph.routers.size());
+  }
 
-  boost::NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  std::vector<uint32_t> sources;
+  for (uint32_t vertex = 0; vertex < graph.routers.size(); ++vertex) {
+    Ptr<Node> node = graph.routers[vertex]->GetObject<Node>();
+    if (node != 0) {
+      sources.push_back(vertex);
+    }
+  }
+  // calculation follows the NodeList order
+  std::sort(sources.begin(), sources.end(), [&graph] (uint32_t a, uint32_t b) {
+      return graph.routers[a]->GetObject<Node>()->GetId() < graph.routers[b]->GetObject<Node>()->GetId();
+    });
+
+  uint32_t nThreads = getRouteCalculationThreads();
+  size_t batchSize = nThreads * BATCH_PER_THREAD;
+  std::vector<std::vector<RouteDistance>> distances(batchSize);
+
+  for (size_t batchStart = 0; batchStart < sources.size(); batchStart += batchSize) {
+    size_t batchEnd = std::min(sources.size(), batchStart + batchSize);
+
+    parallelFor(batchEnd - batchStart, nThreads, [&] (uint32_t, size_t i) {
+        graph.ShortestPaths(sources[batchStart + i], graph.weights, distances[i]);
+      });
+
+    for (size_t i = batchStart; i < batchEnd; ++i) {
+      uint32_t source = sources[i];
+      Ptr<Node> node = graph.routers[source]->GetObject<Node>();
+      const auto& sourceDistances = distances[i - batchStart];
+
+      NS_LOG_DEBUG("Reachability from Node: " << node->GetId());
+      for (uint32_t destination : graph.destinationOrder) {
+        const auto& distance = sourceDistances[destination];
+        if (destination == source || distance.face == NO_FACE) {
+          continue;
+        }
+        for (const auto& prefix : graph.routers[destination]->GetLocalPrefixes()) {
+          NS_LOG_DEBUG(" prefix " << prefix << " reachable via face " << *graph.faces[distance.face]
+                       << " with distance " << distance.metric);
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
-  // the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter>();
-    if (source == 0) {
-      NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
-      continue;
+          FibHelper::AddRoute(node, *prefix, graph.faces[distance.face], distance.metric);
+        }
+      }
+
+      if (g_isIncrementalRouting) {
+        state->distances[source] = std::move(distances[i - batchStart]);
+      }
     }
+  }
+
+  if (g_isIncrementalRouting) {
+    for (uint32_t destination : graph.destinationOrder) {
+      for (const auto& prefix : graph.routers[destination]->GetLocalPrefixes()) {
+        state->origins[*prefix].push_back(destination);
+      }
+    }
+    g_incrementalState = state;
+  }
+}
+
+void
+GlobalRoutingHelper::SetIncrementalRouting(bool isEnabled)
+{
+  if (!isEnabled) {
+    resetIncrementalRouting();
+    return;
+  }
+  if (!g_isIncrementalRouting) {
+    Simulator::ScheduleDestroy(&resetIncrementalRouting);
+  }
+  g_isIncrementalRouting = true;
+}
+
+void
+GlobalRoutingHelper::UpdateRoutesOnLinkChange(Ptr<Node> node1, Ptr<Node> node2, bool isUp)
+{
+  if (!g_isIncrementalRouting) {
+    return;
+  }
+  if (isUp) {
+    g_downLinks.erase(makeLinkKey(node1, node2));
+  }
+  else {
+    g_downLinks.insert(makeLinkKey(node1, node2));
+  }
+  if (g_incrementalState == nullptr) {
+    return; // routes are not calculated yet
+  }
 
-    boost::DistancesMap distances;
+  auto& state = *g_incrementalState;
+  RouteGraph& graph = state.graph;
+  Ptr<GlobalRouter> router1 = node1->GetObject<GlobalRouter>();
+  Ptr<GlobalRouter> router2 = node2->GetObject<GlobalRouter>();
+  NS_ASSERT_MSG(router1 != 0 && router2 != 0, "GlobalRouter is not installed on the link nodes");
 
-    dijkstra_shortest_paths(graph, source,
-                            // predecessor_map (boost::ref(predecessors))
-                            // .
-                            distance_map(boost::ref(distances))
-                              .distance_inf(boost::WeightInf)
-                              .distance_zero(boost::WeightZero)
-                              .distance_compare(boost::WeightCompare())
-                              .distance_combine(boost::WeightCombine()));
+  auto changed = setLinkState(graph, graph.vertexIndex.at(PeekPointer(router1)),
+                              graph.vertexIndex.at(PeekPointer(router2)), isUp);
+  if (changed.empty()) {
+    return;
+  }
 
-    // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+  // A tree is affected if a changed edge was tight in it (the edge may be on a shortest path
+  // that is now longer) or if the edge with its new weight is at least as short as the known
+  // path to its target.  Other trees keep all their distances and first hops.
+  std::vector<uint32_t> affected;
+  size_t nTrees = 0;
+  for (uint32_t source = 0; source < state.distances.size(); ++source) {
+    const auto& distances = state.distances[source];
+    if (distances.empty()) {
+      continue;
+    }
+    nTrees++;
+    for (const auto& edge : changed) {
+      uint64_t oldPath = distances[edge.from].metric + static_cast<uint64_t>(edge.oldWeight.metric);
+      uint64_t newPath = distances[edge.from].metric + static_cast<uint64_t>(graph.weights[edge.index].metric);
+      if (oldPath == distances[edge.to].metric || newPath <= distances[edge.to].metric) {
+        affected.push_back(source);
+        break;
+      }
+    }
+  }
+  NS_LOG_DEBUG("Link " << node1->GetId() << " - " << node2->GetId() << (isUp ? " up" : " down")
+               << ", recalculating " << affected.size() << " of " << nTrees << " trees");
+
+  uint32_t nThreads = getRouteCalculationThreads();
+  size_t batchSize = nThreads * BATCH_PER_THREAD;
+  std::vector<std::vector<RouteDistance>> distances(batchSize);
+
+  for (size_t batchStart = 0; batchStart < affected.size(); batchStart += batchSize) {
+    size_t batchEnd = std::min(affected.size(), batchStart + batchSize);
+
+    parallelFor(batchEnd - batchStart, nThreads, [&] (uint32_t, size_t i) {
+        graph.ShortestPaths(affected[batchStart + i], graph.weights, distances[i]);
+      });
+
+    for (size_t i = batchStart; i < batchEnd; ++i) {
+      uint32_t source = affected[i];
+      Ptr<Node> node = graph.routers[source]->GetObject<Node>();
+      auto& oldDistances = state.distances[source];
+      auto& newDistances = distances[i - batchStart];
+
+      // only prefixes with an origin whose first hop or distance changed are patched
+      std::set<Name> prefixes;
+      for (uint32_t destination = 0; destination < newDistances.size(); ++destination) {
+        if (oldDistances[destination].face != newDistances[destination].face
+            || oldDistances[destination].metric != newDistances[destination].metric) {
+          for (const auto& prefix : graph.routers[destination]->GetLocalPrefixes()) {
+            prefixes.insert(*prefix);
+          }
+        }
+      }
 
-    Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
-    shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
+      for (const auto& prefix : prefixes) {
+        const auto& origins = state.origins[prefix];
+        auto oldNextHops = getNextHops(oldDistances, source, origins);
+        auto newNextHops = getNextHops(newDistances, source, origins);
 
-    NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId());
-    for (const auto& dist : distances) {
-      if (dist.first == source)
-        continue;
-      else {
-        // cout << "  Node " << dist.first->GetObject<Node> ()->GetId ();
-        if (std::get<0>(dist.second) == 0) {
-          // cout << " is unreachable" << endl;
+        for (const auto& nextHop : oldNextHops) {
+          if (newNextHops.count(nextHop.first) == 0) {
+            NS_LOG_DEBUG("Node " << node->GetId() << " removes " << prefix << " via face "
+                         << *graph.faces[nextHop.first]);
+            FibHelper::RemoveRoute(node, prefix, graph.faces[nextHop.first]);
+          }
         }
-        else {
-          for (const auto& prefix : dist.first->GetLocalPrefixes()) {
-            NS_LOG_DEBUG(" prefix " << prefix << " reachable via face " << *std::get<0>(dist.second)
-                         << " with distance " << std::get<1>(dist.second) << " with delay "
-                         << std::get<2>(dist.second));
-
-            FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                std::get<1>(dist.second));
+        for (const auto& nextHop : newNextHops) {
+          auto old = oldNextHops.find(nextHop.first);
+          if (old == oldNextHops.end() || old->second != nextHop.second) {
+            NS_LOG_DEBUG("Node " << node->GetId() << " routes " << prefix << " via face "
+                         << *graph.faces[nextHop.first] << " with distance " << nextHop.second);
+            FibHelper::AddRoute(node, prefix, graph.faces[nextHop.first], nextHop.second);
           }
         }
       }
+
+      oldDistances.swap(newDistances);
     }
   }
 }
@@ -283,105 +671,95 @@ void
 GlobalRoutingHelper::CalculateAllPossibleRoutes()
 {
   /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   * For every node and each of its NetDeviceTransport faces, routes are calculated with only
+   * that face enabled: all other faces of the node get DISABLED_METRIC, and routes through them
+   * are not installed.  Instead of mutating face metrics, each task overrides the weights of the
+   * source's out-edges in a private copy of the snapshot weights, so tasks run in parallel.
    */
 
-  BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
-  BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
+  RouteGraph graph;
 
-  boost::NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  struct Task
+  {
+    uint32_t source;
+    uint32_t enabledFace; // index into graph.faces, or NO_FACE
+  };
+  std::vector<Task> tasks;
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
-  // the graph, which
-  // is not obviously how implement in an efficient manner
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter>();
-    if (source == 0) {
+    Ptr<GlobalRouter> router = (*node)->GetObject<GlobalRouter>();
+    if (router == 0) {
       NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
       continue;
     }
+    uint32_t source = graph.vertexIndex.at(PeekPointer(router));
 
-    Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
-    shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
-
-    NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId() << " ("
-                                            << Names::FindName(source->GetObject<Node>()) << ")");
-
-    Ptr<L3Protocol> l3 = source->GetObject<L3Protocol>();
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
     NS_ASSERT(l3 != 0);
 
-    // remember interface statuses
-    std::list<nfd::FaceId> faceIds;
-    std::unordered_map<nfd::FaceId, uint16_t> originalMetrics;
-    for (auto& nfdFace : l3->getForwarder()->getFaceTable()) {
-      faceIds.push_back(nfdFace.getId());
-      originalMetrics[nfdFace.getId()] = nfdFace.getMetric();
-      nfdFace.setMetric(std::numeric_limits<uint16_t>::max() - 1);
-      // value std::numeric_limits<uint16_t>::max () MUST NOT be used (reserved)
-    }
-
-    for (auto& faceId : faceIds) {
-      auto* face = l3->getForwarder()->getFaceTable().get(faceId);
-      NS_ASSERT(face != nullptr);
-      auto transport = dynamic_cast<NetDeviceTransport*>(face->getTransport());
-      if (transport == nullptr) {
+    for (const auto& nfdFace : l3->getForwarder()->getFaceTable()) {
+      if (dynamic_cast<NetDeviceTransport*>(nfdFace.getTransport()) == nullptr) {
         NS_LOG_DEBUG("Skipping non ndnSIM-specific transport face");
         continue;
       }
+      // a face without incidency still gets its (empty) calculation, as with live metrics
+      auto enabledFace = graph.faceIndex.find(&nfdFace);
+      tasks.push_back({source, enabledFace == graph.faceIndex.end() ? NO_FACE : enabledFace->second});
+    }
+  }
 
-      // enabling only faceId
-      face->setMetric(originalMetrics[faceId]);
+  uint32_t nThreads = getRouteCalculationThreads();
+  size_t batchSize = nThreads * BATCH_PER_THREAD;
+  std::vector<std::vector<RouteDistance>> distances(batchSize);
+  std::vector<std::vector<RouteDistance>> workerWeights(nThreads, graph.weights);
+
+  for (size_t batchStart = 0; batchStart < tasks.size(); batchStart += batchSize) {
+    size_t batchEnd = std::min(tasks.size(), batchStart + batchSize);
+
+    parallelFor(batchEnd - batchStart, nThreads, [&] (uint32_t worker, size_t i) {
+        const Task& task = tasks[batchStart + i];
+        auto& weights = workerWeights[worker];
+        auto edges = boost::out_edges(RouteGraph::Csr::vertex_descriptor(task.source), graph.csr);
+        for (auto edge = edges.first; edge != edges.second; ++edge) {
+          auto& weight = weights[boost::get(boost::edge_index, graph.csr, *edge)];
+          if (weight.face != NO_FACE && weight.face != task.enabledFace) {
+            weight.metric = DISABLED_METRIC;
+          }
+        }
 
-      boost::DistancesMap distances;
+        graph.ShortestPaths(task.source, weights, distances[i]);
 
-      NS_LOG_DEBUG("-----------");
+        for (auto edge = edges.first; edge != edges.second; ++edge) {
+          auto index = boost::get(boost::edge_index, graph.csr, *edge);
+          weights[index] = graph.weights[index];
+        }
+      });
 
-      dijkstra_shortest_paths(graph, source,
-                              // predecessor_map (boost::ref(predecessors))
-                              // .
-                              distance_map(boost::ref(distances))
-                                .distance_inf(boost::WeightInf)
-                                .distance_zero(boost::WeightZero)
-                                .distance_compare(boost::WeightCompare())
-                                .distance_combine(boost::WeightCombine()));
+    for (size_t i = batchStart; i < batchEnd; ++i) {
+      const Task& task = tasks[i];
+      Ptr<Node> node = graph.routers[task.source]->GetObject<Node>();
+      const auto& taskDistances = distances[i - batchStart];
 
-      // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+      NS_LOG_DEBUG("Reachability from Node: " << node->GetId() << " (" << Names::FindName(node) << ")");
+      for (uint32_t destination : graph.destinationOrder) {
+        const auto& distance = taskDistances[destination];
+        if (destination == task.source || distance.face == NO_FACE) {
+          continue;
+        }
 
-      for (const auto& dist : distances) {
-        if (dist.first == source)
+        // routes through disabled faces are not installed
+        bool isDisabled = graph.faceOwners[distance.face] == task.source && distance.face != task.enabledFace;
+        if (isDisabled || static_cast<uint16_t>(graph.faces[distance.face]->getMetric()) == DISABLED_METRIC) {
           continue;
-        else {
-          // cout << "  Node " << dist.first->GetObject<Node> ()->GetId ();
-          if (std::get<0>(dist.second) == 0) {
-            // cout << " is unreachable" << endl;
-          }
-          else {
-            for (const auto& prefix : dist.first->GetLocalPrefixes()) {
-              NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face "
-                           << *std::get<0>(dist.second)
-                           << " with distance " << std::get<1>(dist.second)
-                           << " with delay " << std::get<2>(dist.second));
-
-              if (std::get<0>(dist.second)->getMetric() == std::numeric_limits<uint16_t>::max() - 1)
-                continue;
-
-              FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                  std::get<1>(dist.second));
-            }
-          }
         }
-      }
 
-      // disabling the face again
-      face->setMetric(std::numeric_limits<uint16_t>::max() - 1);
-    }
+        for (const auto& prefix : graph.routers[destination]->GetLocalPrefixes()) {
+          NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face " << *graph.faces[distance.face]
+                       << " with distance " << distance.metric);
 
-    // recover original interface statuses
-    for (auto& i : originalMetrics) {
-      l3->getForwarder()->getFaceTable().get(i.first)->setMetric(i.second);
+          FibHelper::AddRoute(node, *prefix, graph.faces[distance.face], distance.metric);
+        }
+      }
     }
   }
 }
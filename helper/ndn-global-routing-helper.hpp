@@ -111,6 +111,44 @@ public:
   static void
   CalculateAllPossibleRoutes();
 
+  /**
+   * @brief Set the number of threads computing shortest path trees
+   *
+   * Routes are installed by the calling thread regardless of this setting.
+   *
+   * @param nThreads number of threads, or 0 (default) to use all hardware threads
+   */
+  static void
+  SetRouteCalculationThreads(uint32_t nThreads);
+
+  /**
+   * @brief Enable or disable incremental routing
+   *
+   * In incremental mode, CalculateRoutes keeps the shortest path tree of every node, so that
+   * UpdateRoutesOnLinkChange can patch routes when a link goes down or comes up.  The mode is
+   * turned off and the trees are dropped when the simulator is destroyed, so every simulation
+   * run must enable it again.
+   */
+  static void
+  SetIncrementalRouting(bool isEnabled);
+
+  /**
+   * @brief Update routes after the link between two nodes went down or came up
+   *
+   * Only the shortest path trees that may change are recomputed: trees in which the link lies
+   * on a shortest path when it goes down, and trees in which it offers a path at least as short
+   * when it comes up.  Only FIB next hops that changed are removed, added, or updated.
+   *
+   * Does nothing unless incremental routing is enabled.  Links taken down are also excluded by
+   * later calls to CalculateRoutes.  LinkControlHelper::FailLink and UpLink call this method.
+   *
+   * Note that ties between equal-cost paths may resolve differently than in a full
+   * recalculation, and that routes added by other means for a patched prefix on the same face
+   * are overwritten.
+   */
+  static void
+  UpdateRoutesOnLinkChange(Ptr<Node> node1, Ptr<Node> node2, bool isUp);
+
 private:
   void
   Install(Ptr<Channel> channel);
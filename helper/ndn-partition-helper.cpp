@@ -0,0 +1,547 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-partition-helper.hpp"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/node.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <set>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.PartitionHelper");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+// stop coarsening at this many vertices per part
+const uint32_t COARSEST_VERTICES_PER_PART = 15;
+
+// number of region growing attempts on the coarsest graph
+const int N_INITIAL_TRIES = 4;
+
+const int N_REFINEMENT_PASSES = 10;
+
+// Undirected graph with vertex and edge weights
+struct Graph
+{
+  std::vector<uint32_t> vertexWeight;
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> adjacency; // (neighbor, edge weight)
+
+  uint32_t
+  size() const
+  {
+    return vertexWeight.size();
+  }
+};
+
+// Heavy-edge matching: every vertex is collapsed with its unmatched neighbor over the heaviest
+// edge, if any.  fineToCoarse receives the coarse vertex of every fine vertex.
+Graph
+coarsen(const Graph& fine, std::vector<uint32_t>& fineToCoarse, std::mt19937& rng)
+{
+  std::vector<uint32_t> order(fine.size());
+  for (uint32_t v = 0; v < fine.size(); ++v) {
+    order[v] = v;
+  }
+  std::shuffle(order.begin(), order.end(), rng);
+
+  std::vector<uint32_t> match(fine.size(), INVALID);
+  for (uint32_t v : order) {
+    if (match[v] != INVALID) {
+      continue;
+    }
+    uint32_t best = v;
+    uint32_t bestWeight = 0;
+    for (const auto& edge : fine.adjacency[v]) {
+      if (match[edge.first] == INVALID && edge.first != v && edge.second > bestWeight) {
+        best = edge.first;
+        bestWeight = edge.second;
+      }
+    }
+    match[v] = best;
+    match[best] = v;
+  }
+
+  Graph coarse;
+  fineToCoarse.assign(fine.size(), INVALID);
+  std::vector<std::vector<uint32_t>> members;
+  for (uint32_t v = 0; v < fine.size(); ++v) {
+    if (fineToCoarse[v] != INVALID) {
+      continue;
+    }
+    uint32_t c = coarse.size();
+    fineToCoarse[v] = c;
+    members.push_back({v});
+    uint32_t weight = fine.vertexWeight[v];
+    if (match[v] != v) {
+      fineToCoarse[match[v]] = c;
+      members.back().push_back(match[v]);
+      weight += fine.vertexWeight[match[v]];
+    }
+    coarse.vertexWeight.push_back(weight);
+  }
+
+  // merge the edges of collapsed vertices, using position markers to sum parallel edges
+  coarse.adjacency.resize(coarse.size());
+  std::vector<uint32_t> position(coarse.size(), INVALID);
+  for (uint32_t c = 0; c < coarse.size(); ++c) {
+    auto& edges = coarse.adjacency[c];
+    for (uint32_t v : members[c]) {
+      for (const auto& edge : fine.adjacency[v]) {
+        uint32_t neighbor = fineToCoarse[edge.first];
+        if (neighbor == c) {
+          continue;
+        }
+        if (position[neighbor] == INVALID) {
+          position[neighbor] = edges.size();
+          edges.push_back(std::make_pair(neighbor, 0));
+        }
+        edges[position[neighbor]].second += edge.second;
+      }
+    }
+    for (const auto& edge : edges) {
+      position[edge.first] = INVALID;
+    }
+  }
+  return coarse;
+}
+
+uint64_t
+cutWeight(const Graph& graph, const std::vector<uint32_t>& parts)
+{
+  uint64_t cut = 0;
+  for (uint32_t v = 0; v < graph.size(); ++v) {
+    for (const auto& edge : graph.adjacency[v]) {
+      if (parts[v] != parts[edge.first]) {
+        cut += edge.second;
+      }
+    }
+  }
+  return cut / 2;
+}
+
+// Greedy k-way refinement: boundary vertices move to the adjacent part they are most connected
+// to, as long as that part stays within maxWeight.  Vertices of overweight parts are moved out
+// even at a loss, and zero-gain moves are taken when they improve the balance.
+void
+refine(const Graph& graph, std::vector<uint32_t>& parts, uint32_t nParts, uint64_t maxWeight)
+{
+  std::vector<uint64_t> partWeight(nParts, 0);
+  for (uint32_t v = 0; v < graph.size(); ++v) {
+    partWeight[parts[v]] += graph.vertexWeight[v];
+  }
+
+  std::vector<int64_t> connectivity(nParts, 0);
+  std::vector<uint32_t> touched;
+  for (int pass = 0; pass < N_REFINEMENT_PASSES; ++pass) {
+    bool moved = false;
+    for (uint32_t v = 0; v < graph.size(); ++v) {
+      uint32_t from = parts[v];
+      uint32_t weight = graph.vertexWeight[v];
+      if (partWeight[from] == weight) {
+        continue; // never empty a part
+      }
+
+      touched.clear();
+      for (const auto& edge : graph.adjacency[v]) {
+        uint32_t part = parts[edge.first];
+        if (connectivity[part] == 0) {
+          touched.push_back(part);
+        }
+        connectivity[part] += edge.second;
+      }
+
+      bool overweight = partWeight[from] > maxWeight;
+      uint32_t best = from;
+      int64_t bestGain = overweight ? std::numeric_limits<int64_t>::min() : 0;
+      for (uint32_t part : touched) {
+        if (part == from || partWeight[part] + weight > maxWeight) {
+          continue;
+        }
+        int64_t gain = connectivity[part] - connectivity[from];
+        if (gain > bestGain
+            || (gain == bestGain && best != from && partWeight[part] < partWeight[best])
+            || (gain == 0 && best == from && partWeight[part] + weight < partWeight[from])) {
+          best = part;
+          bestGain = gain;
+        }
+      }
+      if (overweight && best == from) {
+        // no adjacent part has room: move to the lightest part
+        best = std::min_element(partWeight.begin(), partWeight.end()) - partWeight.begin();
+      }
+
+      for (uint32_t part : touched) {
+        connectivity[part] = 0;
+      }
+
+      if (best != from) {
+        parts[v] = best;
+        partWeight[from] -= weight;
+        partWeight[best] += weight;
+        moved = true;
+      }
+    }
+    if (!moved) {
+      break;
+    }
+  }
+}
+
+// Greedy graph growing: parts 0..nParts-2 are grown one at a time from a seed vertex, always
+// absorbing the frontier vertex most connected to the region; the remainder forms the last part
+std::vector<uint32_t>
+growRegions(const Graph& graph, uint32_t nParts, std::mt19937& rng)
+{
+  uint64_t total = 0;
+  for (uint32_t weight : graph.vertexWeight) {
+    total += weight;
+  }
+
+  std::vector<uint32_t> parts(graph.size(), nParts - 1);
+  std::vector<bool> assigned(graph.size(), false);
+  std::vector<uint64_t> connectivity(graph.size(), 0);
+  uint64_t assignedWeight = 0;
+
+  for (uint32_t part = 0; part + 1 < nParts; ++part) {
+    uint64_t target = (total - assignedWeight) / (nParts - part);
+    uint64_t weight = 0;
+    std::set<uint32_t> frontier;
+
+    while (weight < target) {
+      uint32_t next = INVALID;
+      if (frontier.empty()) {
+        // (re)seed from a random unassigned vertex, e.g., in another connected component
+        std::vector<uint32_t> free;
+        for (uint32_t v = 0; v < graph.size(); ++v) {
+          if (!assigned[v]) {
+            free.push_back(v);
+          }
+        }
+        if (free.empty()) {
+          break;
+        }
+        next = free[std::uniform_int_distribution<size_t>(0, free.size() - 1)(rng)];
+
+        // seed at a pseudo-peripheral vertex, the last one reached by BFS over unassigned
+        // vertices, so the region does not cut the rest of the graph in two
+        std::vector<bool> reached(graph.size(), false);
+        std::vector<uint32_t> queue{next};
+        reached[next] = true;
+        for (size_t head = 0; head < queue.size(); ++head) {
+          for (const auto& edge : graph.adjacency[queue[head]]) {
+            if (!assigned[edge.first] && !reached[edge.first]) {
+              reached[edge.first] = true;
+              queue.push_back(edge.first);
+            }
+          }
+        }
+        next = queue.back();
+      }
+      else {
+        uint64_t bestConnectivity = 0;
+        for (uint32_t v : frontier) {
+          if (next == INVALID || connectivity[v] > bestConnectivity) {
+            next = v;
+            bestConnectivity = connectivity[v];
+          }
+        }
+        frontier.erase(next);
+      }
+
+      assigned[next] = true;
+      parts[next] = part;
+      weight += graph.vertexWeight[next];
+      for (const auto& edge : graph.adjacency[next]) {
+        if (!assigned[edge.first]) {
+          connectivity[edge.first] += edge.second;
+          frontier.insert(edge.first);
+        }
+      }
+    }
+
+    for (uint32_t v : frontier) {
+      connectivity[v] = 0;
+    }
+    assignedWeight += weight;
+  }
+  return parts;
+}
+
+} // namespace
+
+PartitionHelper::PartitionHelper()
+  : m_imbalance(0.05)
+  , m_nParts(0)
+{
+}
+
+uint32_t
+PartitionHelper::AddNode(const std::string& name)
+{
+  uint32_t index = m_names.size();
+  if (!name.empty()) {
+    NS_ASSERT_MSG(m_nameIndex.find(name) == m_nameIndex.end(), "Duplicate node name " << name);
+    m_nameIndex[name] = index;
+  }
+  m_names.push_back(name);
+  return index;
+}
+
+void
+PartitionHelper::AddNodes(uint32_t n)
+{
+  m_names.resize(m_names.size() + n);
+}
+
+void
+PartitionHelper::AddLink(uint32_t node1, uint32_t node2, Time delay, uint32_t weight)
+{
+  NS_ASSERT_MSG(node1 < m_names.size() && node2 < m_names.size(), "Link between unknown nodes");
+  m_links.push_back(Link{node1, node2, delay, weight});
+}
+
+void
+PartitionHelper::AddLink(const std::string& node1, const std::string& node2, Time delay,
+                         uint32_t weight)
+{
+  AddLink(GetNodeIndex(node1), GetNodeIndex(node2), delay, weight);
+}
+
+void
+PartitionHelper::AddTopology(const std::string& file)
+{
+  std::ifstream topology(file.c_str());
+  if (!topology.is_open() || !topology.good()) {
+    NS_FATAL_ERROR("Cannot open file " << file << " for reading");
+  }
+
+  std::string line;
+  while (std::getline(topology, line) && line != "router") {
+  }
+  while (std::getline(topology, line) && line != "link") {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream lineBuffer(line);
+    std::string name;
+    lineBuffer >> name;
+    if (!name.empty()) {
+      AddNode(name);
+    }
+  }
+
+  std::set<std::pair<std::string, std::string>> processedLinks; // to eliminate duplications
+  while (std::getline(topology, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream lineBuffer(line);
+    std::string from, to, capacity, metric, delay;
+    lineBuffer >> from >> to >> capacity >> metric >> delay;
+    if (from.empty() || to.empty() || processedLinks.count(std::make_pair(to, from)) > 0) {
+      continue;
+    }
+    processedLinks.insert(std::make_pair(from, to));
+    AddLink(from, to, delay.empty() ? Time() : Time(delay));
+  }
+}
+
+void
+PartitionHelper::SetImbalance(double imbalance)
+{
+  m_imbalance = imbalance;
+}
+
+void
+PartitionHelper::Partition(uint32_t nParts)
+{
+  NS_ASSERT_MSG(nParts > 0, "Number of partitions must be positive");
+  m_nParts = nParts;
+  m_parts.assign(m_names.size(), 0);
+  if (nParts == 1 || m_names.empty()) {
+    return;
+  }
+
+  std::vector<Graph> levels(1);
+  Graph& base = levels.front();
+  base.vertexWeight.assign(m_names.size(), 1);
+  base.adjacency.resize(m_names.size());
+  for (const auto& link : m_links) {
+    if (link.node1 != link.node2) {
+      base.adjacency[link.node1].push_back(std::make_pair(link.node2, link.weight));
+      base.adjacency[link.node2].push_back(std::make_pair(link.node1, link.weight));
+    }
+  }
+
+  uint64_t maxWeight = static_cast<uint64_t>(std::ceil(m_names.size() * (1 + m_imbalance) / nParts));
+
+  // fixed seed: every MPI rank must compute the same partition
+  std::mt19937 rng(1);
+
+  std::vector<std::vector<uint32_t>> fineToCoarse;
+  while (levels.back().size() > COARSEST_VERTICES_PER_PART * nParts) {
+    std::vector<uint32_t> mapping;
+    Graph coarse = coarsen(levels.back(), mapping, rng);
+    if (coarse.size() * 20 > levels.back().size() * 19) {
+      break; // matching no longer shrinks the graph
+    }
+    levels.push_back(std::move(coarse));
+    fineToCoarse.push_back(std::move(mapping));
+  }
+
+  const Graph& coarsest = levels.back();
+  std::vector<uint32_t> parts;
+  uint64_t bestCut = std::numeric_limits<uint64_t>::max();
+  for (int i = 0; i < N_INITIAL_TRIES; ++i) {
+    auto candidate = growRegions(coarsest, nParts, rng);
+    refine(coarsest, candidate, nParts, maxWeight);
+    uint64_t cut = cutWeight(coarsest, candidate);
+    if (cut < bestCut) {
+      bestCut = cut;
+      parts = std::move(candidate);
+    }
+  }
+
+  for (size_t level = levels.size() - 1; level > 0; --level) {
+    const auto& mapping = fineToCoarse[level - 1];
+    std::vector<uint32_t> fineParts(mapping.size());
+    for (uint32_t v = 0; v < mapping.size(); ++v) {
+      fineParts[v] = parts[mapping[v]];
+    }
+    parts = std::move(fineParts);
+    refine(levels[level - 1], parts, nParts, maxWeight);
+  }
+
+  m_parts = std::move(parts);
+  NS_LOG_INFO("Partitioned " << m_names.size() << " nodes into " << nParts << " parts in "
+                             << levels.size() << " levels, cut size " << GetCutSize());
+}
+
+uint32_t
+PartitionHelper::GetNodeIndex(const std::string& name) const
+{
+  auto it = m_nameIndex.find(name);
+  if (it == m_nameIndex.end()) {
+    NS_FATAL_ERROR("Node " << name << " is unknown to the partition helper");
+  }
+  return it->second;
+}
+
+uint32_t
+PartitionHelper::GetSystemId(uint32_t node) const
+{
+  NS_ASSERT_MSG(node < m_parts.size(), "Partition() has not been called for node " << node);
+  return m_parts[node];
+}
+
+uint32_t
+PartitionHelper::GetSystemId(const std::string& name) const
+{
+  return GetSystemId(GetNodeIndex(name));
+}
+
+std::map<std::string, uint32_t>
+PartitionHelper::GetSystemIds() const
+{
+  std::map<std::string, uint32_t> systemIds;
+  for (const auto& named : m_nameIndex) {
+    systemIds[named.first] = GetSystemId(named.second);
+  }
+  return systemIds;
+}
+
+NodeContainer
+PartitionHelper::CreateNodes() const
+{
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < m_names.size(); ++i) {
+    Ptr<Node> node = CreateObject<Node>(GetSystemId(i));
+    if (!m_names[i].empty()) {
+      Names::Add(m_names[i], node);
+    }
+    nodes.Add(node);
+  }
+  return nodes;
+}
+
+uint32_t
+PartitionHelper::GetCutSize() const
+{
+  uint32_t cut = 0;
+  for (const auto& link : m_links) {
+    if (GetSystemId(link.node1) != GetSystemId(link.node2)) {
+      cut += link.weight;
+    }
+  }
+  return cut;
+}
+
+uint32_t
+PartitionHelper::GetNNodes(uint32_t rank) const
+{
+  return std::count(m_parts.begin(), m_parts.end(), rank);
+}
+
+Time
+PartitionHelper::GetLookahead(uint32_t rank) const
+{
+  Time lookahead = Time::Max();
+  for (const auto& link : m_links) {
+    uint32_t rank1 = GetSystemId(link.node1);
+    uint32_t rank2 = GetSystemId(link.node2);
+    if (rank1 != rank2 && (rank1 == rank || rank2 == rank)) {
+      lookahead = std::min(lookahead, link.delay);
+    }
+  }
+  return lookahead;
+}
+
+void
+PartitionHelper::PrintReport(std::ostream& os) const
+{
+  os << "Partition of " << m_names.size() << " nodes into " << m_nParts
+     << " ranks, cut size " << GetCutSize() << std::endl;
+  for (uint32_t rank = 0; rank < m_nParts; ++rank) {
+    os << "  rank " << rank << ": " << GetNNodes(rank) << " nodes, lookahead ";
+    Time lookahead = GetLookahead(rank);
+    if (lookahead == Time::Max()) {
+      os << "unbounded";
+    }
+    else {
+      os << lookahead.As(Time::MS);
+    }
+    os << std::endl;
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
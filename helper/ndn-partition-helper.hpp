@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_PARTITION_HELPER_H
+#define NDN_PARTITION_HELPER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Helper to assign the nodes of a distributed (MPI) simulation to ranks
+ *
+ * The system ID of an ns-3 node is fixed when the node is created, so nodes and links are
+ * described to the helper first.  Partition() then computes a balanced assignment that
+ * minimizes the weight of links crossing ranks, using multilevel graph partitioning: the graph
+ * is coarsened by heavy-edge matching, the coarsest graph is split by greedy region growing,
+ * and the split is refined at every level while it is projected back.
+ *
+ * The computation is deterministic, so every rank obtains the same assignment.
+ */
+class PartitionHelper {
+public:
+  PartitionHelper();
+
+  /**
+   * @brief Add a node and return its index
+   * @param name optional name, registered with Names when the node is created
+   */
+  uint32_t
+  AddNode(const std::string& name = "");
+
+  /**
+   * @brief Add n unnamed nodes
+   */
+  void
+  AddNodes(uint32_t n);
+
+  /**
+   * @brief Add a link between two nodes
+   * @param delay  propagation delay of the link, which bounds the lookahead if the link is cut
+   * @param weight cost of cutting the link
+   */
+  void
+  AddLink(uint32_t node1, uint32_t node2, Time delay, uint32_t weight = 1);
+
+  void
+  AddLink(const std::string& node1, const std::string& node2, Time delay, uint32_t weight = 1);
+
+  /**
+   * @brief Add nodes and links of a topology file in AnnotatedTopologyReader format
+   *
+   * The computed assignment is then passed to the reader with
+   * AnnotatedTopologyReader::SetSystemIds(GetSystemIds()) before reading the topology.
+   */
+  void
+  AddTopology(const std::string& file);
+
+  /**
+   * @brief Set the allowed deviation of a rank's node count from the average (default 0.05)
+   */
+  void
+  SetImbalance(double imbalance);
+
+  /**
+   * @brief Compute the assignment of nodes to nParts ranks
+   */
+  void
+  Partition(uint32_t nParts);
+
+  uint32_t
+  GetSystemId(uint32_t node) const;
+
+  uint32_t
+  GetSystemId(const std::string& name) const;
+
+  /**
+   * @brief Get the system IDs of all named nodes
+   */
+  std::map<std::string, uint32_t>
+  GetSystemIds() const;
+
+  /**
+   * @brief Create all nodes, in index order, with their assigned system IDs
+   */
+  NodeContainer
+  CreateNodes() const;
+
+  /**
+   * @brief Get the total weight of links crossing ranks
+   */
+  uint32_t
+  GetCutSize() const;
+
+  /**
+   * @brief Get the number of nodes assigned to the rank
+   */
+  uint32_t
+  GetNNodes(uint32_t rank) const;
+
+  /**
+   * @brief Get the lookahead of the rank, i.e., the minimal delay of its cut links
+   *
+   * Time::Max() is returned if the rank has no cut links.
+   */
+  Time
+  GetLookahead(uint32_t rank) const;
+
+  /**
+   * @brief Print the cut size, and the node count and lookahead of every rank
+   */
+  void
+  PrintReport(std::ostream& os) const;
+
+private:
+  uint32_t
+  GetNodeIndex(const std::string& name) const;
+
+private:
+  struct Link {
+    uint32_t node1;
+    uint32_t node2;
+    Time delay;
+    uint32_t weight;
+  };
+
+  std::vector<std::string> m_names;
+  std::map<std::string, uint32_t> m_nameIndex;
+  std::vector<Link> m_links;
+  double m_imbalance;
+
+  uint32_t m_nParts;
+  std::vector<uint32_t> m_parts;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_PARTITION_HELPER_H
@@ -88,6 +88,12 @@ ScenarioHelper::disableForwarderStatusManager()
   ndnHelper.disableForwarderStatusManager();
 }
 
+void
+ScenarioHelper::setForwardingOnly()
+{
+  ndnHelper.setForwardingOnly();
+}
+
 void
 ScenarioHelper::addRoutes(std::initializer_list<ScenarioHelper::RouteInfo> routes)
 {
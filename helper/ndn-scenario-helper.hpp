@@ -190,6 +190,14 @@ public: // topology accessors
   void
   disableForwarderStatusManager();
 
+  /**
+   * \brief Install forwarding-only stacks, without the management plane
+   *
+   * \see StackHelper::setForwardingOnly
+   */
+  void
+  setForwardingOnly();
+
   /**
    * \brief Get NDN stack helper, e.g., to adjust its parameters
    */
@@ -37,6 +37,9 @@
 #include <boost/lexical_cast.hpp>
 
 #include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+#include "ns3/ndnSIM/NFD/daemon/mgmt/tables-config-section.hpp"
+#include "ns3/ndnSIM/NFD/core/config-file.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/cs-policy-priority-fifo.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/cs-policy-lru.hpp"
 
@@ -50,6 +53,7 @@ StackHelper::StackHelper()
   // , m_isFaceManagerDisabled(false)
   , m_isForwarderStatusManagerDisabled(false)
   , m_isStrategyChoiceManagerDisabled(false)
+  , m_isForwardingOnly(false)
   , m_needSetDefaultRoutes(false)
   , m_maxCsSize(100)
 {
@@ -118,6 +122,7 @@ StackHelper::SetOldContentStore(const std::string& contentStore, const std::stri
                                 const std::string& value4)
 {
   m_maxCsSize = 0;
+  m_nfdConfig = nullptr;
 
   m_contentStoreFactory.SetTypeId(contentStore);
   if (attr1 != "")
@@ -134,6 +139,7 @@ void
 StackHelper::setCsSize(size_t maxSize)
 {
   m_maxCsSize = maxSize;
+  m_nfdConfig = nullptr;
 }
 
 void
@@ -180,24 +186,7 @@ StackHelper::Install(Ptr<Node> node) const
   }
 
   Ptr<L3Protocol> ndn = m_ndnFactory.Create<L3Protocol>();
-
-  if (m_isRibManagerDisabled) {
-    ndn->getConfig().put("ndnSIM.disable_rib_manager", true);
-  }
-
-  // if (m_isFaceManagerDisabled) {
-  //   ndn->getConfig().put("ndnSIM.disable_face_manager", true);
-  // }
-
-  if (m_isForwarderStatusManagerDisabled) {
-    ndn->getConfig().put("ndnSIM.disable_forwarder_status_manager", true);
-  }
-
-  if (m_isStrategyChoiceManagerDisabled) {
-    ndn->getConfig().put("ndnSIM.disable_strategy_choice_manager", true);
-  }
-
-  ndn->getConfig().put("tables.cs_max_packets", (m_maxCsSize == 0) ? 1 : m_maxCsSize);
+  ndn->setConfig(getNfdConfig());
 
   // Create and aggregate content store if NFD's contest store has been disabled
   if (m_maxCsSize == 0) {
@@ -224,6 +213,54 @@ StackHelper::Install(Ptr<Node> node) const
   return faces;
 }
 
+shared_ptr<const nfd::ConfigSection>
+StackHelper::getNfdConfig() const
+{
+  if (m_nfdConfig != nullptr) {
+    return m_nfdConfig;
+  }
+
+  auto config = make_shared<nfd::ConfigSection>(*L3Protocol::getDefaultConfig());
+
+  if (m_isRibManagerDisabled) {
+    config->put("ndnSIM.disable_rib_manager", true);
+  }
+
+  // if (m_isFaceManagerDisabled) {
+  //   config->put("ndnSIM.disable_face_manager", true);
+  // }
+
+  if (m_isForwarderStatusManagerDisabled) {
+    config->put("ndnSIM.disable_forwarder_status_manager", true);
+  }
+
+  if (m_isStrategyChoiceManagerDisabled) {
+    config->put("ndnSIM.disable_strategy_choice_manager", true);
+    config->get_child("authorizations.authorize.privileges").erase("strategy-choice");
+  }
+
+  if (m_isForwardingOnly) {
+    config->put("ndnSIM.forwarding_only", true);
+  }
+
+  config->put("tables.cs_max_packets", (m_maxCsSize == 0) ? 1 : m_maxCsSize);
+
+  // validate the tables section once, instead of failing on every node
+  try {
+    nfd::Forwarder forwarder;
+    nfd::TablesConfigSection tablesConfig(forwarder);
+    nfd::ConfigFile configFile(&nfd::ConfigFile::ignoreUnknownSection);
+    tablesConfig.setConfigFile(configFile);
+    configFile.parse(*config, true, "ndnSIM.conf");
+  }
+  catch (const std::exception& e) {
+    NS_FATAL_ERROR("Invalid NFD config: " << e.what());
+  }
+
+  m_nfdConfig = config;
+  return m_nfdConfig;
+}
+
 void
 StackHelper::AddFaceCreateCallback(TypeId netDeviceType,
                                    StackHelper::FaceCreateCallback callback)
@@ -409,6 +446,7 @@ void
 StackHelper::disableRibManager()
 {
   m_isRibManagerDisabled = true;
+  m_nfdConfig = nullptr;
 }
 
 // void
@@ -421,12 +459,21 @@ void
 StackHelper::disableStrategyChoiceManager()
 {
   m_isStrategyChoiceManagerDisabled = true;
+  m_nfdConfig = nullptr;
 }
 
 void
 StackHelper::disableForwarderStatusManager()
 {
   m_isForwarderStatusManagerDisabled = true;
+  m_nfdConfig = nullptr;
+}
+
+void
+StackHelper::setForwardingOnly()
+{
+  m_isForwardingOnly = true;
+  m_nfdConfig = nullptr;
 }
 
 void
@@ -248,6 +248,21 @@ public:
   void
   disableForwarderStatusManager();
 
+  /**
+   * \brief Install a forwarding-only stack, without the management plane
+   *
+   * The stack gets the forwarder with its tables configured, but no internal face, managers,
+   * dispatchers, or RIB manager.  FibHelper and StrategyChoiceHelper then modify the tables
+   * directly.  Applications that send management commands, e.g., prefix registrations of an
+   * ndn-cxx Face, are not supported; routes must be installed with FibHelper or
+   * GlobalRoutingHelper.
+   *
+   * Intended for large topologies, in which the management plane dominates startup time and
+   * memory usage.
+   */
+  void
+  setForwardingOnly();
+
   /**
    * @brief Set face metric of all faces connected through PointToPoint channel to channel latency
    */
@@ -264,10 +279,19 @@ private:
   shared_ptr<Face>
   createAndRegisterFace(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> device) const;
 
+  /**
+   * \brief Get the NFD config shared by all stacks the helper installs
+   *
+   * The config is built and validated on first use after a change of the helper parameters.
+   */
+  shared_ptr<const nfd::ConfigSection>
+  getNfdConfig() const;
+
   bool m_isRibManagerDisabled;
   // bool m_isFaceManagerDisabled;
   bool m_isForwarderStatusManagerDisabled;
   bool m_isStrategyChoiceManagerDisabled;
+  bool m_isForwardingOnly;
 
 public:
   void
@@ -279,6 +303,7 @@ private:
 
   bool m_needSetDefaultRoutes;
   size_t m_maxCsSize;
+  mutable shared_ptr<const nfd::ConfigSection> m_nfdConfig;
 
   typedef std::function<std::unique_ptr<nfd::cs::Policy>()> PolicyCreationCallback;
   PolicyCreationCallback m_csPolicyCreationFunc;
@@ -55,7 +55,9 @@ using ::ndn::nfd::ControlParameters;
  *
  * The Strategy Choice helper interacts with the Strategy Choice manager of NFD by sending
  * special Interest commands to the manager in order to specify the desired per-name
- * prefix forwarding strategy for one, more or all the nodes of a topology.
+ * prefix forwarding strategy for one, more or all the nodes of a topology.  On a
+ * forwarding-only stack (StackHelper::setForwardingOnly), the Strategy Choice table is
+ * modified directly.
  */
 class StrategyChoiceHelper
 {
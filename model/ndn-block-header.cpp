@@ -19,16 +19,11 @@
 
 #include "ndn-block-header.hpp"
 
-#include <iosfwd>
-#include <boost/iostreams/concepts.hpp>
-#include <boost/iostreams/stream.hpp>
-
 #include <ndn-cxx/encoding/tlv.hpp>
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/data.hpp>
 #include <ndn-cxx/lp/packet.hpp>
 
-namespace io = boost::iostreams;
 namespace nfdFace = nfd::face;
 
 namespace ns3 {
@@ -73,37 +68,50 @@ BlockHeader::Serialize(ns3::Buffer::Iterator start) const
   start.Write(m_block.wire(), m_block.size());
 }
 
-class Ns3BufferIteratorSource : public io::source {
-public:
-  Ns3BufferIteratorSource(ns3::Buffer::Iterator& is)
-    : m_is(is)
-  {
+// Reads a VAR-NUMBER, appending its octets to the TLV header being collected
+static uint64_t
+readVarNumber(ns3::Buffer::Iterator& is, uint8_t* header, size_t& headerSize)
+{
+  if (is.IsEnd()) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Insufficient data during TLV header processing"));
   }
-
-  std::streamsize
-  read(char* buf, std::streamsize nMaxRead)
-  {
-    std::streamsize i = 0;
-    for (; i < nMaxRead && !m_is.IsEnd(); ++i) {
-      buf[i] = m_is.ReadU8();
-    }
-    if (i == 0) {
-      return -1;
-    }
-    else {
-      return i;
-    }
+  uint8_t first = is.ReadU8();
+  header[headerSize++] = first;
+  if (first < 253) {
+    return first;
   }
 
-private:
-  ns3::Buffer::Iterator& m_is;
-};
+  size_t size = first == 253 ? 2 : (first == 254 ? 4 : 8);
+  if (is.GetRemainingSize() < size) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Insufficient data during TLV header processing"));
+  }
+  uint64_t number = 0;
+  for (size_t i = 0; i != size; ++i) {
+    uint8_t octet = is.ReadU8();
+    header[headerSize++] = octet;
+    number = (number << 8) | octet;
+  }
+  return number;
+}
 
 uint32_t
 BlockHeader::Deserialize(ns3::Buffer::Iterator start)
 {
-  io::stream<Ns3BufferIteratorSource> is(start);
-  m_block = ::ndn::Block::fromStream(is);
+  // TLV-TYPE and TLV-LENGTH take at most 9 octets each
+  uint8_t header[18];
+  size_t headerSize = 0;
+  readVarNumber(start, header, headerSize);
+  uint64_t length = readVarNumber(start, header, headerSize);
+  if (length > start.GetRemainingSize()) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("TLV-LENGTH exceeds the packet size"));
+  }
+
+  // size the wire once and fill the value with a single bulk read
+  auto buffer = make_shared< ::ndn::Buffer>(headerSize + length);
+  std::copy(header, header + headerSize, buffer->begin());
+  start.Read(buffer->data() + headerSize, static_cast<uint32_t>(length));
+
+  m_block = Block(buffer);
   return m_block.size();
 }
 
@@ -108,61 +108,72 @@ L3Protocol::GetTypeId(void)
   return tid;
 }
 
+shared_ptr<const nfd::ConfigSection>
+L3Protocol::getDefaultConfig()
+{
+  static shared_ptr<const nfd::ConfigSection> defaultConfig = [] {
+      // Do not modify initial config file. Use helpers to set specific NFD parameters
+      std::string initialConfig =
+        "general\n"
+        "{\n"
+        "}\n"
+        "\n"
+        "tables\n"
+        "{\n"
+        "  cs_max_packets 100\n"
+        "\n"
+        "  strategy_choice\n"
+        "  {\n"
+        "    /               /localhost/nfd/strategy/best-route\n"
+        "    /localhost      /localhost/nfd/strategy/multicast\n"
+        "    /localhost/nfd  /localhost/nfd/strategy/best-route\n"
+        "    /ndn/multicast  /localhost/nfd/strategy/multicast\n"
+        "  }\n"
+        "}\n"
+        "\n"
+        // "face_system\n"
+        // "{\n"
+        // "}\n"
+        "\n"
+        "authorizations\n"
+        "{\n"
+        "  authorize\n"
+        "  {\n"
+        "    certfile any\n"
+        "    privileges\n"
+        "    {\n"
+        "      faces\n"
+        "      fib\n"
+        "      strategy-choice\n"
+        "    }\n"
+        "  }\n"
+        "}\n"
+        "\n"
+        "rib\n"
+        "{\n"
+        "  localhost_security\n"
+        "  {\n"
+        "    trust-anchor\n"
+        "    {\n"
+        "      type any\n"
+        "    }\n"
+        "  }\n"
+        "}\n"
+        "\n";
+
+      auto config = make_shared<nfd::ConfigSection>();
+      std::istringstream input(initialConfig);
+      boost::property_tree::read_info(input, *config);
+      return config;
+    }();
+  return defaultConfig;
+}
+
 class L3Protocol::Impl {
 private:
   Impl()
+    : m_config(L3Protocol::getDefaultConfig())
   {
-    // Do not modify initial config file. Use helpers to set specific NFD parameters
-    std::string initialConfig =
-      "general\n"
-      "{\n"
-      "}\n"
-      "\n"
-      "tables\n"
-      "{\n"
-      "  cs_max_packets 100\n"
-      "\n"
-      "  strategy_choice\n"
-      "  {\n"
-      "    /               /localhost/nfd/strategy/best-route\n"
-      "    /localhost      /localhost/nfd/strategy/multicast\n"
-      "    /localhost/nfd  /localhost/nfd/strategy/best-route\n"
-      "    /ndn/multicast  /localhost/nfd/strategy/multicast\n"
-      "  }\n"
-      "}\n"
-      "\n"
-      // "face_system\n"
-      // "{\n"
-      // "}\n"
-      "\n"
-      "authorizations\n"
-      "{\n"
-      "  authorize\n"
-      "  {\n"
-      "    certfile any\n"
-      "    privileges\n"
-      "    {\n"
-      "      faces\n"
-      "      fib\n"
-      "      strategy-choice\n"
-      "    }\n"
-      "  }\n"
-      "}\n"
-      "\n"
-      "rib\n"
-      "{\n"
-      "  localhost_security\n"
-      "  {\n"
-      "    trust-anchor\n"
-      "    {\n"
-      "      type any\n"
-      "    }\n"
-      "  }\n"
-      "}\n"
-      "\n";
-
-    std::istringstream input(initialConfig);
-    boost::property_tree::read_info(input, m_config);
   }
 
   friend class L3Protocol;
@@ -186,10 +197,16 @@ private:
 
   std::shared_ptr<nfd::face::FaceSystem> m_faceSystem;
 
-  nfd::ConfigSection m_config;
+  // config shared with other stacks, and the overrides of this stack
+  shared_ptr<const nfd::ConfigSection> m_config;
+  nfd::ConfigSection m_configOverrides;
+  // private copy of the config, made by getConfig()
+  shared_ptr<nfd::ConfigSection> m_ownConfig;
 
   Ptr<ContentStore> m_csFromNdnSim;
   PolicyCreationCallback m_policy;
+
+  bool m_isForwardingOnly = false;
 };
 
 L3Protocol::L3Protocol()
@@ -208,12 +225,18 @@ L3Protocol::initialize()
 {
   m_impl->m_forwarder = make_shared<nfd::Forwarder>();
 
-  initializeManagement();
+  m_impl->m_isForwardingOnly = isConfigFlagSet("ndnSIM.forwarding_only");
+  if (m_impl->m_isForwardingOnly) {
+    initializeTables();
+  }
+  else {
+    initializeManagement();
+  }
 
   nfd::FaceTable& faceTable = m_impl->m_forwarder->getFaceTable();
   faceTable.addReserved(nfd::face::makeNullFace(), nfd::face::FACEID_NULL);
 
-  if (!this->getConfig().get<bool>("ndnSIM.disable_rib_manager", false)) {
+  if (!m_impl->m_isForwardingOnly && !isConfigFlagSet("ndnSIM.disable_rib_manager")) {
     Simulator::ScheduleWithContext(m_node->GetId(), Seconds(0), &L3Protocol::initializeRibManager, this);
   }
 
@@ -245,9 +268,17 @@ private:
 void
 L3Protocol::injectInterest(const Interest& interest)
 {
+  NS_ASSERT_MSG(m_impl->m_internalFace != nullptr,
+                "Forwarding-only stack has no internal face to inject Interests");
   m_impl->m_internalFace->sendInterest(interest);
 }
 
+bool
+L3Protocol::isForwardingOnly() const
+{
+  return m_impl->m_isForwardingOnly;
+}
+
 void
 L3Protocol::setCsReplacementPolicy(const PolicyCreationCallback& policy)
 {
@@ -284,16 +315,23 @@ L3Protocol::initializeManagement()
   //   this->getConfig().get_child("authorizations").get_child("authorize").get_child("privileges").erase("faces");
   // }
 
-  if (!this->getConfig().get<bool>("ndnSIM.disable_strategy_choice_manager", false)) {
+  shared_ptr<const ConfigSection> nfdConfig = getMergedConfig();
+  if (!isConfigFlagSet("ndnSIM.disable_strategy_choice_manager")) {
     m_impl->m_strategyChoiceManager.reset(new StrategyChoiceManager(forwarder->getStrategyChoice(),
                                                                     *m_impl->m_dispatcher,
                                                                     *m_impl->m_authenticator));
   }
   else {
-    this->getConfig().get_child("authorizations").get_child("authorize").get_child("privileges").erase("strategy-choice");
+    auto privileges = nfdConfig->get_child_optional("authorizations.authorize.privileges");
+    if (privileges && privileges->count("strategy-choice") > 0) {
+      // StackHelper shares a config without the privilege, so only other configs are copied
+      auto config = make_shared<ConfigSection>(*nfdConfig);
+      config->get_child("authorizations.authorize.privileges").erase("strategy-choice");
+      nfdConfig = config;
+    }
   }
 
-  if (!this->getConfig().get<bool>("ndnSIM.disable_forwarder_status_manager", false)) {
+  if (!isConfigFlagSet("ndnSIM.disable_forwarder_status_manager")) {
     m_impl->m_forwarderStatusManager.reset(new ForwarderStatusManager(*forwarder, *m_impl->m_dispatcher));
   }
 
@@ -315,7 +353,7 @@ L3Protocol::initializeManagement()
   // }
 
   // apply config
-  config.parse(m_impl->m_config, false, "ndnSIM.conf");
+  config.parse(*nfdConfig, false, "ndnSIM.conf");
 
   tablesConfig.ensureConfigured();
 
@@ -326,6 +364,31 @@ L3Protocol::initializeManagement()
   m_impl->m_dispatcher->addTopPrefix(topPrefix, false);
 }
 
+void
+L3Protocol::initializeTables()
+{
+  auto& forwarder = m_impl->m_forwarder;
+  using namespace nfd;
+
+  // if we use NFD's CS, we have to specify a replacement policy
+  m_impl->m_csFromNdnSim = GetObject<ContentStore>();
+  if (m_impl->m_csFromNdnSim == nullptr) {
+    forwarder->getCs().setPolicy(m_impl->m_policy());
+  }
+
+  ConfigFile config(&ConfigFile::ignoreUnknownSection);
+
+  TablesConfigSection tablesConfig(*forwarder);
+  tablesConfig.setConfigFile(config);
+
+  // apply only the tables section; the others configure management
+  ConfigSection tables;
+  tables.put_child("tables", getMergedConfig()->get_child("tables"));
+  config.parse(tables, false, "ndnSIM.conf");
+
+  tablesConfig.ensureConfigured();
+}
+
 void
 L3Protocol::initializeRibManager()
 {
@@ -355,7 +418,7 @@ L3Protocol::initializeRibManager()
   m_impl->m_ribManager->setConfigFile(config);
 
   // apply config
-  config.parse(m_impl->m_config, false, "ndnSIM.conf");
+  config.parse(*getMergedConfig(), false, "ndnSIM.conf");
 
   m_impl->m_ribManager->registerWithNfd();
 }
@@ -381,7 +444,75 @@ L3Protocol::getStrategyChoiceManager()
 nfd::ConfigSection&
 L3Protocol::getConfig()
 {
-  return m_impl->m_config;
+  if (m_impl->m_ownConfig == nullptr) {
+    m_impl->m_ownConfig = make_shared<nfd::ConfigSection>(*getMergedConfig());
+    m_impl->m_config = m_impl->m_ownConfig;
+    m_impl->m_configOverrides.clear();
+  }
+  return *m_impl->m_ownConfig;
+}
+
+void
+L3Protocol::setConfig(shared_ptr<const nfd::ConfigSection> config)
+{
+  NS_ASSERT_MSG(m_node == nullptr, "Config must be set before the stack is aggregated to a node");
+  m_impl->m_config = std::move(config);
+  m_impl->m_ownConfig = nullptr;
+}
+
+void
+L3Protocol::overrideConfig(const std::string& path, const std::string& value)
+{
+  NS_ASSERT_MSG(m_node == nullptr, "Config must be set before the stack is aggregated to a node");
+  if (m_impl->m_ownConfig != nullptr) {
+    m_impl->m_ownConfig->put(path, value);
+  }
+  else {
+    m_impl->m_configOverrides.put(path, value);
+  }
+}
+
+static void
+applyConfigOverrides(nfd::ConfigSection& config, const nfd::ConfigSection& overrides)
+{
+  for (const auto& item : overrides) {
+    auto child = config.get_child_optional(item.first);
+    if (!child) {
+      config.push_back(item);
+    }
+    else if (item.second.empty()) {
+      child->put_value(item.second.data());
+    }
+    else {
+      applyConfigOverrides(*child, item.second);
+    }
+  }
+}
+
+shared_ptr<const nfd::ConfigSection>
+L3Protocol::getMergedConfig() const
+{
+  // ndnSIM flags are read by isConfigFlagSet and ignored by NFD, so they need no copy
+  auto isNfdSection = [] (const nfd::ConfigSection::value_type& item) {
+    return item.first != "ndnSIM";
+  };
+  if (std::none_of(m_impl->m_configOverrides.begin(), m_impl->m_configOverrides.end(),
+                   isNfdSection)) {
+    return m_impl->m_config;
+  }
+  auto config = make_shared<nfd::ConfigSection>(*m_impl->m_config);
+  applyConfigOverrides(*config, m_impl->m_configOverrides);
+  return config;
+}
+
+bool
+L3Protocol::isConfigFlagSet(const std::string& path) const
+{
+  auto value = m_impl->m_configOverrides.get_optional<bool>(path);
+  if (value) {
+    return *value;
+  }
+  return m_impl->m_config->get<bool>(path, false);
 }
 
 /*
@@ -146,16 +146,56 @@ public:
 
   /**
    * \brief Get NFD config (boost::property_tree)
+   *
+   * The first call replaces the shared config of the stack with a private copy that includes
+   * the overrides, so it costs a full copy of the config per stack.  Use overrideConfig or
+   * setConfig to configure many stacks.
    */
   nfd::ConfigSection&
   getConfig();
 
+  /**
+   * \brief Set the NFD config, e.g., to share one parsed config between stacks
+   *
+   * Must be called before the stack is aggregated to a node.  By default, a stack uses the
+   * initial config of getDefaultConfig.
+   */
+  void
+  setConfig(shared_ptr<const nfd::ConfigSection> config);
+
+  /**
+   * \brief Override a value of the NFD config on this stack only
+   *
+   * The override is kept apart from the shared config, which is not copied unless the stack
+   * has overrides of sections that NFD parses.  Must be called before the stack is aggregated
+   * to a node.
+   */
+  void
+  overrideConfig(const std::string& path, const std::string& value);
+
+  /**
+   * \brief Get the initial NFD config, parsed once and shared by all stacks
+   */
+  static shared_ptr<const nfd::ConfigSection>
+  getDefaultConfig();
+
   /**
    * \brief Inject interest through internal Face
    */
   void
   injectInterest(const Interest& interest);
 
+  /**
+   * \brief Check if the stack was installed without the management plane
+   *
+   * A forwarding-only stack has no internal face and no managers, so FibHelper and
+   * StrategyChoiceHelper modify its tables directly instead of sending management commands.
+   *
+   * \see StackHelper::setForwardingOnly
+   */
+  bool
+  isForwardingOnly() const;
+
   typedef std::function<std::unique_ptr<nfd::cs::Policy>()> PolicyCreationCallback;
 
   /**
@@ -195,9 +235,21 @@ private:
   void
   initializeManagement();
 
+  void
+  initializeTables();
+
   void
   initializeRibManager();
 
+  /**
+   * \brief Get the shared config with the overrides of this stack applied
+   */
+  shared_ptr<const nfd::ConfigSection>
+  getMergedConfig() const;
+
+  bool
+  isConfigFlagSet(const std::string& path) const;
+
 private:
   class Impl;
   std::unique_ptr<Impl> m_impl;
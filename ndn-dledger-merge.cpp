@@ -6,9 +6,11 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/ndnSIM-module.h"
 #include "ns3/ndnSIM/apps/ndn-peer.hpp"
+#include "ns3/ndnSIM/helper/ndn-partition-helper.hpp"
 #include "ns3/mpi-interface.h"
 #include <map>
 #include <chrono>
+#include <fstream>
 
 #ifdef NS3_MPI
 #include <mpi.h>
@@ -23,9 +25,12 @@ using namespace ns3;
 using ns3::ndn::StackHelper;
 using ns3::ndn::AppHelper;
 using ns3::ndn::L3RateTracer;
+using ns3::ndn::PeerTracer;
 using ns3::ndn::FibHelper;
 using ns3::ndn::StrategyChoiceHelper;
 using ns3::ndn::GlobalRoutingHelper;
+using ns3::ndn::PartitionHelper;
+using ns3::ndn::LinkControlHelper;
 
 NS_LOG_COMPONENT_DEFINE ("ndn.dledger");
 
@@ -34,68 +39,53 @@ const int EntropyThreshold = 3;
 const int MaxEntropy = 5;
 const double TotalTime = 150.0;
 
-void
-failLink(Ptr<NetDevice> nd)
-{
-  Ptr<RateErrorModel> error = CreateObject<RateErrorModel> ();
-  error->SetAttribute ("ErrorRate", DoubleValue (1.0));
-  nd->SetAttribute ("ReceiveErrorModel", PointerValue(error));
-}
-
-void
-upLink(Ptr<NetDevice> nd)
-{
-  Ptr<RateErrorModel> error = CreateObject<RateErrorModel> ();
-  error->SetAttribute ("ErrorRate", DoubleValue (-0.1));
-  nd->SetAttribute ("ReceiveErrorModel", PointerValue(error));
-}
+// ledger snapshots and progress, kept apart from the output of the other processes
+std::ofstream g_output;
 
-// TODO: THE RESULTS INTERWAVES; USE FILE TO OUTPUT.
 void
 inspectRecords()
 {
-  map<std::string, std::string> namemap;
+  vector<std::string> namemap;
 
   for(auto node = NodeList::Begin(); node != NodeList::End(); ++ node) {
     if((*node)->GetNApplications() == 0)
       continue;
     auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
     auto & ledger = peer->GetLedger();
-    cout << "================================================" << endl;
-    cout << "TIME: " << Simulator::Now() << endl;
-    cout << "Node Id: " << (*node)->GetId() << " Ledger Size: " << ledger.size() << endl;
-    cout << "digraph{" << endl;
+    g_output << "================================================" << endl;
+    g_output << "TIME: " << Simulator::Now() << endl;
+    g_output << "Node Id: " << (*node)->GetId() << " Ledger Size: " << ledger.size() << endl;
+    g_output << "digraph{" << endl;
 
     namemap.clear();
-    int cnt = 0;
-    for(auto & it : ledger){
-      namemap[it.first] = it.first.substr(9, 16);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      namemap.push_back(peer->GetRecordName(id).toUri().substr(9, 16));
     }
 
-    for(auto & it : ledger) {
-      auto approvees = peer->GetApprovedBlocks(it.second.block);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      const auto & approvees = ledger[id].approvals;
 
-      cout << "\"" << namemap[it.first] << "\"";
+      g_output << "\"" << namemap[id] << "\"";
 
       if(approvees.size() > 0){
-        cout << " -> {";
+        g_output << " -> {";
         for(const auto & approvee : approvees){
-          cout << " \"" << namemap[approvee] << "\"";
+          g_output << " \"" << namemap[approvee] << "\"";
         }
-        cout << " }";
+        g_output << " }";
       }
 
       
-      // if(it.second.approverNames.size() > 0){
-      //   cout << " -> {";
-      //   for(auto & approver : it.second.approverNames) {
-      //     cout << " \"" << namemap[approver] << "\"";
+      // if(ledger[id].approvers.size() > 0){
+      //   g_output << " -> {";
+      //   for(auto approver : ledger[id].approvers.GetOrdinals()) {
+      //     g_output << " \"" << peer->GetProducer(approver) << "\"";
       //   }
-      //   cout << " }";
+      //   g_output << " }";
       // }
-      cout << endl;
+      g_output << endl;
     }
-    cout << "}" << endl;
+    g_output << "}" << endl;
 
     //break;
   }
@@ -108,10 +98,10 @@ void
 showProgress(){
   auto end_time = std::chrono::steady_clock::now();
   static int progress = 0;
-  std::cout << ++ progress << "% "
-            << std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count()
-            << "sec";
-            //<< std::endl;
+  g_output << ++ progress << "% "
+           << std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count()
+           << "sec";
+           //<< std::endl;
 
   auto node = NodeList::Begin();
   for(; node != NodeList::End(); ++ node) {
@@ -122,15 +112,10 @@ showProgress(){
 
   auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
   auto & ledger = peer->GetLedger();
-  int unconfirmedCnt = 0;
-  for(const auto & record : ledger){
-    if(record.second.entropy < EntropyThreshold) { // EntropyThreshold -> confirm
-      unconfirmedCnt ++;
-    }
-  }
-  std::cout << " Total Count=" << ledger.size();
-  std::cout << " Unconfirmed Count=" << unconfirmedCnt;
-  std::cout << std::endl;
+  int unconfirmedCnt = peer->GetUnconfirmedCount(); // maintained incrementally by the peer
+  g_output << " Total Count=" << ledger.size();
+  g_output << " Unconfirmed Count=" << unconfirmedCnt;
+  g_output << std::endl;
 
   Simulator::Schedule(Seconds(1.0), showProgress);
 }
@@ -154,14 +139,22 @@ main(int argc, char *argv[])
   MpiInterface::Enable(&argc, &argv);
 
   uint32_t systemId = MpiInterface::GetSystemId();
+  g_output.open("dledger-output-" + std::to_string(systemId) + ".txt");
   uint32_t systemCount = MpiInterface::GetSize();
 
   // Creating nodes
   int node_num = NodesCnt;
-  NodeContainer nodes;
-  for(int i = 0; i < node_num; i ++){
-    nodes.Create(1, i % systemCount);
+  // Assigning nodes to ranks so that as few links as possible cross ranks
+  PartitionHelper partitioner;
+  partitioner.AddNodes(node_num);
+  for (int i = 0; i < node_num - 1; i++) {
+    partitioner.AddLink(i, i + 1, MilliSeconds(10));
+  }
+  partitioner.Partition(systemCount);
+  if (systemId == 0) {
+    partitioner.PrintReport(std::cout);
   }
+  NodeContainer nodes = partitioner.CreateNodes();
 
   // Connecting nodes using two links
   PointToPointHelper p2p;
@@ -172,6 +165,8 @@ main(int argc, char *argv[])
   // Install NDN stack on all nodes
   StackHelper ndnHelper;
   ndnHelper.SetDefaultRoutes(true);
+  // peers only use the forwarder, and routes are installed by GlobalRoutingHelper
+  ndnHelper.setForwardingOnly();
   ndnHelper.InstallAll();
 
   // Finish Preparation****************************************************
@@ -189,7 +184,7 @@ main(int argc, char *argv[])
     Ptr<Node> object = *i;
     std::string prefix = "/dledger/node" + std::to_string(counter);
 
-    if(counter % systemCount == systemId){
+    if(object->GetSystemId() == systemId){
       AppHelper sleepingAppHelper("Peer");
       sleepingAppHelper.SetAttribute("Routable-Prefix", StringValue(prefix));
       sleepingAppHelper.SetAttribute("Multicast-Prefix", StringValue("/dledger"));
@@ -202,7 +197,11 @@ main(int argc, char *argv[])
       sleepingAppHelper.SetAttribute("MaxEntropy", IntegerValue(MaxEntropy));
       sleepingAppHelper.SetAttribute("EntropyThreshold", IntegerValue(EntropyThreshold));
 
-      sleepingAppHelper.Install(object).Start(Seconds(2));
+      auto apps = sleepingAppHelper.Install(object);
+      apps.Start(Seconds(2));
+      // streams derived from the node, so a run is reproducible whatever the partitioning
+      DynamicCast<ns3::ndn::Peer>(apps.Get(0))
+        ->AssignStreams(object->GetId() * ns3::ndn::Peer::STREAMS_PER_PEER);
     }
 
     // Add /prefix origins to ndn::GlobalRouter
@@ -211,15 +210,15 @@ main(int argc, char *argv[])
     counter++;
   }
 
-  // Calculate and install FIBs
+  // Calculate and install FIBs, keeping the shortest path trees to patch them on link changes
+  GlobalRoutingHelper::SetIncrementalRouting(true);
   GlobalRoutingHelper::CalculateRoutes();
 
   // Finish Installation****************************************************
-  Simulator::Schedule(Seconds(20.0), failLink, nodes.Get(4)->GetDevice(0));
-  Simulator::Schedule(Seconds(120.0), upLink, nodes.Get(4)->GetDevice(0));
-  // Simulator::Schedule(Seconds(5.0), failLink, nodes.Get(31)->GetDevice(0));
-  // Simulator::Schedule(Seconds(5.0), failLink, nodes.Get(50)->GetDevice(0));
-  // Simulator::Schedule(Seconds(5.0), failLink, nodes.Get(51)->GetDevice(0));
+  Simulator::Schedule(Seconds(20.0), LinkControlHelper::FailLink, nodes.Get(3), nodes.Get(4));
+  Simulator::Schedule(Seconds(120.0), LinkControlHelper::UpLink, nodes.Get(3), nodes.Get(4));
+  // Simulator::Schedule(Seconds(5.0), LinkControlHelper::FailLink, nodes.Get(30), nodes.Get(31));
+  // Simulator::Schedule(Seconds(5.0), LinkControlHelper::FailLink, nodes.Get(50), nodes.Get(51));
   // Simulator::Schedule(Seconds(99.0), inspectRecords);
   if(systemId == 0){
     Simulator::Schedule(Seconds(1.0), showProgress);
@@ -227,6 +226,8 @@ main(int argc, char *argv[])
   }
   Simulator::Stop(Seconds(TotalTime));
 
+  PeerTracer::InstallAll("peer-trace-" + std::to_string(systemId) + ".txt");
+
   start_time = std::chrono::steady_clock::now();
 
   Simulator::Run();
@@ -6,9 +6,11 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/ndnSIM-module.h"
 #include "ns3/ndnSIM/apps/ndn-peer.hpp"
+#include "ns3/ndnSIM/helper/ndn-partition-helper.hpp"
 #include "ns3/mpi-interface.h"
 #include <map>
 #include <chrono>
+#include <fstream>
 
 #ifdef NS3_MPI
 #include <mpi.h>
@@ -23,9 +25,11 @@ using namespace ns3;
 using ns3::ndn::StackHelper;
 using ns3::ndn::AppHelper;
 using ns3::ndn::L3RateTracer;
+using ns3::ndn::PeerTracer;
 using ns3::ndn::FibHelper;
 using ns3::ndn::StrategyChoiceHelper;
 using ns3::ndn::GlobalRoutingHelper;
+using ns3::ndn::PartitionHelper;
 
 NS_LOG_COMPONENT_DEFINE ("ndn.dledger");
 
@@ -42,49 +46,50 @@ failLink(Ptr<NetDevice> nd)
   nd->SetAttribute ("ReceiveErrorModel", PointerValue(error));
 }
 
-// TODO: THE RESULTS INTERWAVES; USE FILE TO OUTPUT.
+// ledger snapshots and progress, kept apart from the output of the other processes
+std::ofstream g_output;
+
 void
 inspectRecords()
 {
-  map<std::string, std::string> namemap;
+  vector<std::string> namemap;
 
   for(auto node = NodeList::Begin(); node != NodeList::End(); ++ node) {
     if((*node)->GetNApplications() == 0)
       continue;
     auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
     auto & ledger = peer->GetLedger();
-    cout << "================================================" << endl;
-    cout << "TIME: " << Simulator::Now() << endl;
-    cout << "Node Id: " << (*node)->GetId() << " Ledger Size: " << ledger.size() << endl;
-    cout << "digraph{" << endl;
+    g_output << "================================================" << endl;
+    g_output << "TIME: " << Simulator::Now() << endl;
+    g_output << "Node Id: " << (*node)->GetId() << " Ledger Size: " << ledger.size() << endl;
+    g_output << "digraph{" << endl;
 
     namemap.clear();
-    int cnt = 0;
-    for(auto & it : ledger){
-      namemap[it.first] = it.first.substr(9, 16);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      namemap.push_back(peer->GetRecordName(id).toUri().substr(9, 16));
     }
 
-    for(auto & it : ledger) {
-      auto approvees = peer->GetApprovedBlocks(it.second.block);
+    for(ns3::ndn::RecordId id = 0; id != ledger.size(); ++ id) {
+      const auto & approvees = ledger[id].approvals;
       if(approvees.size() > 0){
-        cout << "{";
+        g_output << "{";
         for(const auto & approvee : approvees){
-          cout << " \"" << namemap[approvee] << "\"";
+          g_output << " \"" << namemap[approvee] << "\"";
         }
-        cout << " } -> ";
+        g_output << " } -> ";
       }
 
-      cout << "\"" << namemap[it.first] << "\"";
-      // if(it.second.approverNames.size() > 0){
-      //   cout << " -> {";
-      //   for(auto & approver : it.second.approverNames) {
-      //     cout << " \"" << namemap[approver] << "\"";
+      g_output << "\"" << namemap[id] << "\"";
+      // if(ledger[id].approvers.size() > 0){
+      //   g_output << " -> {";
+      //   for(auto approver : ledger[id].approvers.GetOrdinals()) {
+      //     g_output << " \"" << peer->GetProducer(approver) << "\"";
       //   }
-      //   cout << " }";
+      //   g_output << " }";
       // }
-      cout << endl;
+      g_output << endl;
     }
-    cout << "}" << endl;
+    g_output << "}" << endl;
 
     break;
   }
@@ -97,10 +102,10 @@ void
 showProgress(){
   auto end_time = std::chrono::steady_clock::now();
   static int progress = 0;
-  std::cout << ++ progress << " "
-            << std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count()
-            << "";
-            //<< std::endl;
+  g_output << ++ progress << " "
+           << std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count()
+           << "";
+           //<< std::endl;
 
   auto node = NodeList::Begin();
   for(; node != NodeList::End(); ++ node) {
@@ -111,15 +116,10 @@ showProgress(){
 
   auto peer = DynamicCast<ns3::ndn::Peer>((*node)->GetApplication(0));
   auto & ledger = peer->GetLedger();
-  int unconfirmedCnt = 0;
-  for(const auto & record : ledger){
-    if(record.second.entropy < EntropyThreshold) { // EntropyThreshold -> confirm
-      unconfirmedCnt ++;
-    }
-  }
-  std::cout << " " << ledger.size();
-  std::cout << " " << unconfirmedCnt;
-  std::cout << std::endl;
+  int unconfirmedCnt = peer->GetUnconfirmedCount(); // maintained incrementally by the peer
+  g_output << " " << ledger.size();
+  g_output << " " << unconfirmedCnt;
+  g_output << std::endl;
 
   Simulator::Schedule(Seconds(1.0), showProgress);
 }
@@ -143,14 +143,22 @@ main(int argc, char *argv[])
   MpiInterface::Enable(&argc, &argv);
 
   uint32_t systemId = MpiInterface::GetSystemId();
+  g_output.open("dledger-output-" + std::to_string(systemId) + ".txt");
   uint32_t systemCount = MpiInterface::GetSize();
 
   // Creating nodes
   int node_num = NodesCnt;
-  NodeContainer nodes;
-  for(int i = 0; i < node_num; i ++){
-    nodes.Create(1, i % systemCount);
+  // Assigning nodes to ranks so that as few links as possible cross ranks
+  PartitionHelper partitioner;
+  partitioner.AddNodes(node_num);
+  for (int i = 0; i < node_num - 1; i++) {
+    partitioner.AddLink(i, i + 1, MilliSeconds(10));
+  }
+  partitioner.Partition(systemCount);
+  if (systemId == 0) {
+    partitioner.PrintReport(std::cout);
   }
+  NodeContainer nodes = partitioner.CreateNodes();
 
   // Connecting nodes using two links
   PointToPointHelper p2p;
@@ -161,6 +169,8 @@ main(int argc, char *argv[])
   // Install NDN stack on all nodes
   StackHelper ndnHelper;
   ndnHelper.SetDefaultRoutes(true);
+  // peers only use the forwarder, and routes are installed by GlobalRoutingHelper
+  ndnHelper.setForwardingOnly();
   ndnHelper.InstallAll();
 
   // Finish Preparation****************************************************
@@ -178,7 +188,7 @@ main(int argc, char *argv[])
     Ptr<Node> object = *i;
     std::string prefix = "/dledger/node" + std::to_string(counter);
 
-    if(counter % systemCount == systemId){
+    if(object->GetSystemId() == systemId){
       AppHelper sleepingAppHelper("Peer");
       sleepingAppHelper.SetAttribute("Routable-Prefix", StringValue(prefix));
       sleepingAppHelper.SetAttribute("Multicast-Prefix", StringValue("/dledger"));
@@ -191,7 +201,11 @@ main(int argc, char *argv[])
       sleepingAppHelper.SetAttribute("ConEntropy", IntegerValue(ConEntropy));
       sleepingAppHelper.SetAttribute("EntropyThreshold", IntegerValue(EntropyThreshold));
 
-      sleepingAppHelper.Install(object).Start(Seconds(2));
+      auto apps = sleepingAppHelper.Install(object);
+      apps.Start(Seconds(2));
+      // streams derived from the node, so a run is reproducible whatever the partitioning
+      DynamicCast<ns3::ndn::Peer>(apps.Get(0))
+        ->AssignStreams(object->GetId() * ns3::ndn::Peer::STREAMS_PER_PEER);
     }
 
     // Add /prefix origins to ndn::GlobalRouter
@@ -214,6 +228,8 @@ main(int argc, char *argv[])
   }
   Simulator::Stop(Seconds(TotalTime));
 
+  PeerTracer::InstallAll("peer-trace-" + std::to_string(systemId) + ".txt");
+
   start_time = std::chrono::steady_clock::now();
 
   Simulator::Run();
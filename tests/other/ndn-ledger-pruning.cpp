@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-ledger-pruning.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ns3/ndnSIM/utils/mem-usage.hpp"
+
+namespace ns3 {
+
+/**
+ * This scenario measures the resident set size of the process over a DLedger run on a line
+ * of `nodes` peers, keeping every record or pruning deeply archived ones:
+ *
+ *     ./waf --run ndn-ledger-pruning --command-template="%s --prune-depth=200"
+ *
+ * Every `period` seconds, the time, the RSS and the records pruned by all peers are printed.
+ * Each profile must be measured in a separate run (see ndn-ledger-pruning.sh).
+ */
+
+class Tester {
+public:
+  Tester()
+    : m_nNodes(20)
+    , m_pruneDepth(0)
+    , m_duration(500)
+    , m_period(10)
+    , m_nPruned(0)
+  {
+  }
+
+  int
+  run(int argc, char* argv[]);
+
+private:
+  void
+  RecordPruned(uint32_t oldValue, uint32_t newValue);
+
+  void
+  PrintMemUsage();
+
+private:
+  uint32_t m_nNodes;
+  uint32_t m_pruneDepth;
+  std::string m_spillFile;
+  double m_duration;
+  double m_period;
+
+  uint64_t m_nPruned;
+};
+
+void
+Tester::RecordPruned(uint32_t oldValue, uint32_t newValue)
+{
+  m_nPruned += newValue - oldValue;
+}
+
+void
+Tester::PrintMemUsage()
+{
+  std::cout << Simulator::Now().ToDouble(Time::S) << "\t"
+            << MemUsage::Get() / 1024.0 / 1024.0 << "\t"
+            << m_nPruned << "\n";
+
+  Simulator::Schedule(Seconds(m_period), &Tester::PrintMemUsage, this);
+}
+
+int
+Tester::run(int argc, char* argv[])
+{
+  CommandLine cmd;
+  cmd.AddValue("nodes", "Number of peers, connected in a line", m_nNodes);
+  cmd.AddValue("prune-depth", "PruneDepth of the peers, 0 keeps every record", m_pruneDepth);
+  cmd.AddValue("spill-file", "SpillFile of the peers", m_spillFile);
+  cmd.AddValue("duration", "Simulated seconds", m_duration);
+  cmd.AddValue("period", "Seconds between two measurements", m_period);
+  cmd.Parse(argc, argv);
+
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+
+  NodeContainer nodes;
+  nodes.Create(m_nNodes);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i + 1 < m_nNodes; i++) {
+    p2p.Install(nodes.Get(i), nodes.Get(i + 1));
+  }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/multicast");
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+
+  for (uint32_t i = 0; i < m_nNodes; i++) {
+    std::string prefix = "/dledger/node" + std::to_string(i);
+    ndn::AppHelper peerHelper("Peer");
+    peerHelper.SetAttribute("Routable-Prefix", StringValue(prefix));
+    peerHelper.SetAttribute("Multicast-Prefix", StringValue("/dledger"));
+    peerHelper.SetAttribute("PruneDepth", UintegerValue(m_pruneDepth));
+    peerHelper.SetAttribute("SpillFile", StringValue(m_spillFile));
+    peerHelper.Install(nodes.Get(i)).Start(Seconds(2));
+
+    ndnGlobalRoutingHelper.AddOrigins(prefix, nodes.Get(i));
+    ndnGlobalRoutingHelper.AddOrigins("/dledger", nodes.Get(i));
+  }
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/RecordsPruned",
+                                MakeCallback(&Tester::RecordPruned, this));
+
+  std::cout << "Time (s)"
+            << "\t"
+            << "RSS (MiB)"
+            << "\t"
+            << "Pruned"
+            << "\n";
+  Simulator::ScheduleNow(&Tester::PrintMemUsage, this);
+
+  Simulator::Stop(Seconds(m_duration));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  ns3::Tester tester;
+  return tester.run(argc, argv);
+}
@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Compares the memory usage over a DLedger run without and with pruning of archived records.
+# Each profile runs in its own process, as the memory is measured by the resident set size.
+
+echo "Keeping every record.."
+../../../waf --run ndn-ledger-pruning --command-template="%s --prune-depth=0"
+
+echo "Pruning records 200 archivals deep.."
+../../../waf --run ndn-ledger-pruning --command-template="%s --prune-depth=200"
+
+echo "Pruning records 200 archivals deep to a spill file.."
+../../../waf --run ndn-ledger-pruning --command-template="%s --prune-depth=200 --spill-file=/tmp/dledger-spill"
+rm -f /tmp/dledger-spill-*
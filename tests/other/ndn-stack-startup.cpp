@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-stack-startup.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ns3/ndnSIM/utils/mem-usage.hpp"
+
+#include <chrono>
+#include <cmath>
+
+namespace ns3 {
+
+/**
+ * This scenario measures the startup time and the memory usage of the NDN stack on a
+ * grid of about `nodes` nodes, with the full stack or with the forwarding-only stack:
+ *
+ *     ./waf --run ndn-stack-startup --command-template="%s --nodes=5000 --forwarding-only=1"
+ *
+ * The memory is the growth of the resident set size of the process (MemUsage), so each
+ * profile must be measured in a separate run (see ndn-stack-startup.sh).
+ */
+
+class Tester {
+public:
+  Tester()
+    : m_nNodes(5000)
+    , m_isForwardingOnly(false)
+  {
+  }
+
+  int
+  run(int argc, char* argv[]);
+
+private:
+  uint32_t m_nNodes;
+  bool m_isForwardingOnly;
+};
+
+int
+Tester::run(int argc, char* argv[])
+{
+  CommandLine cmd;
+  cmd.AddValue("nodes", "Approximate number of nodes, arranged in a square grid", m_nNodes);
+  cmd.AddValue("forwarding-only", "Install the forwarding-only stack, without management",
+               m_isForwardingOnly);
+  cmd.Parse(argc, argv);
+
+  uint32_t side = std::max<uint32_t>(2, std::ceil(std::sqrt(m_nNodes)));
+  PointToPointHelper p2p;
+  PointToPointGridHelper grid(side, side, p2p);
+
+  double topologyMemory = MemUsage::Get() / 1024.0 / 1024.0;
+  auto start = std::chrono::steady_clock::now();
+
+  ndn::StackHelper ndnHelper;
+  if (m_isForwardingOnly) {
+    ndnHelper.setForwardingOnly();
+  }
+  ndnHelper.InstallAll();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+  ndnGlobalRoutingHelper.AddOrigins("/prefix", grid.GetNode(side - 1, side - 1));
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+
+  // the RIB manager of the full stack is created by the first simulation event
+  Simulator::Stop(Seconds(0));
+  Simulator::Run();
+
+  double startupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double stackMemory = MemUsage::Get() / 1024.0 / 1024.0 - topologyMemory;
+
+  std::cout << "Profile"
+            << "\t"
+            << "Nodes"
+            << "\t"
+            << "StartupTime (s)"
+            << "\t"
+            << "StackMemory (MiB)"
+            << "\t"
+            << "PerNode (KiB)"
+            << "\n";
+  std::cout << (m_isForwardingOnly ? "forwarding-only" : "full") << "\t"
+            << NodeList::GetNNodes() << "\t"
+            << startupTime << "\t"
+            << stackMemory << "\t"
+            << 1024 * stackMemory / NodeList::GetNNodes() << "\n";
+
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  ns3::Tester tester;
+  return tester.run(argc, argv);
+}
@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Compares startup time and memory usage of the full and the forwarding-only NDN stack.
+# Each profile runs in its own process, as the memory is measured by the resident set size.
+
+for nodes in 1000 5000; do
+  echo "Number of nodes = " $nodes
+
+  echo "Full stack.."
+  ../../../waf --run ndn-stack-startup --command-template="%s --nodes=${nodes}"
+
+  echo "Forwarding-only stack.."
+  ../../../waf --run ndn-stack-startup --command-template="%s --nodes=${nodes} --forwarding-only=1"
+
+  echo
+done
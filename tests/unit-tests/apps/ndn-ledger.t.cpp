@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/ndn-ledger.hpp"
+
+#include "../tests-common.hpp"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(AppsNdnLedger)
+
+// /dledger/node/<64 hex digits, all equal to hexDigit>
+static Name
+makeRecordName(char hexDigit)
+{
+  return Name("/dledger/node").append(name::Component(std::string(64, hexDigit)));
+}
+
+BOOST_AUTO_TEST_CASE(GetDigest)
+{
+  RecordDigest digest;
+  BOOST_REQUIRE(Ledger::GetDigest(makeRecordName('a'), digest));
+  BOOST_CHECK_EQUAL(digest.front(), 0xAA);
+  BOOST_CHECK_EQUAL(digest.back(), 0xAA);
+
+  RecordDigest upper;
+  BOOST_REQUIRE(Ledger::GetDigest(makeRecordName('A'), upper));
+  BOOST_CHECK(upper == digest);
+
+  BOOST_CHECK(!Ledger::GetDigest(Name(), digest));
+  BOOST_CHECK(!Ledger::GetDigest(Name("/dledger/node/aa"), digest));
+  BOOST_CHECK(!Ledger::GetDigest(makeRecordName('g'), digest));
+}
+
+BOOST_AUTO_TEST_CASE(InsertAndFind)
+{
+  Ledger ledger;
+  BOOST_CHECK_EQUAL(ledger.find(makeRecordName('1')), INVALID_RECORD_ID);
+
+  for (char hexDigit : {'1', '2', '3'}) {
+    auto id = ledger.insert(LedgerRecord(std::make_shared<Data>(makeRecordName(hexDigit))));
+    BOOST_CHECK_EQUAL(id, ledger.size() - 1);
+  }
+  BOOST_CHECK_EQUAL(ledger.size(), 3);
+
+  RecordDigest digest;
+  Ledger::GetDigest(makeRecordName('2'), digest);
+  BOOST_CHECK_EQUAL(ledger.find(digest), 1);
+  BOOST_CHECK_EQUAL(ledger.find(makeRecordName('2')), 1);
+  BOOST_CHECK(ledger[1].digest == digest);
+  BOOST_CHECK_EQUAL(ledger[1].block->getName(), makeRecordName('2'));
+
+  // a record already in the ledger keeps its ID
+  LedgerRecord duplicate(std::make_shared<Data>(makeRecordName('2')));
+  duplicate.weight = 10;
+  BOOST_CHECK_EQUAL(ledger.insert(duplicate), 1);
+  BOOST_CHECK_EQUAL(ledger.size(), 3);
+  BOOST_CHECK_EQUAL(ledger[1].weight, 1);
+
+  // a name without a digest is not interned
+  BOOST_CHECK_EQUAL(ledger.insert(LedgerRecord(std::make_shared<Data>(Name("/dledger/node")))),
+                    INVALID_RECORD_ID);
+  BOOST_CHECK_EQUAL(ledger.find(Name("/dledger/node")), INVALID_RECORD_ID);
+  BOOST_CHECK_EQUAL(ledger.size(), 3);
+}
+
+// The tips of a pool, in increasing order
+static std::set<RecordId>
+getPool(const std::vector<RecordId>& pool)
+{
+  return std::set<RecordId>(pool.begin(), pool.end());
+}
+
+BOOST_AUTO_TEST_CASE(TipSetPools)
+{
+  TipSet tips;
+  tips.Insert(0, true);
+  tips.Insert(1, false);
+  tips.Insert(2, true);
+  tips.Insert(2, false); // already a tip
+  BOOST_CHECK_EQUAL(tips.size(), 3);
+  BOOST_CHECK_EQUAL(tips.EligibleSize(), 2);
+  BOOST_CHECK(tips.Contains(1));
+  BOOST_CHECK(!tips.Contains(3));
+  BOOST_CHECK(!tips.Contains(1000));
+
+  tips.SetEligible(2, false);
+  BOOST_CHECK((getPool(tips.GetEligible()) == std::set<RecordId>{0}));
+  BOOST_CHECK((getPool(tips.GetIneligible()) == std::set<RecordId>{1, 2}));
+
+  tips.SetEligible(1, true);
+  tips.SetEligible(3, true); // not a tip
+  BOOST_CHECK((getPool(tips.GetEligible()) == std::set<RecordId>{0, 1}));
+  BOOST_CHECK((getPool(tips.GetIneligible()) == std::set<RecordId>{2}));
+  BOOST_CHECK(!tips.Contains(3));
+}
+
+BOOST_AUTO_TEST_CASE(TipSetErase)
+{
+  TipSet tips;
+  for (RecordId id = 0; id != 5; id++) {
+    tips.Insert(id, true);
+  }
+
+  // the last tip takes the freed position, and must still be found there
+  tips.Erase(1);
+  BOOST_CHECK_EQUAL(tips.GetEligible()[1], 4);
+  tips.Erase(4);
+  tips.Erase(4);
+  BOOST_CHECK((getPool(tips.GetEligible()) == std::set<RecordId>{0, 2, 3}));
+
+  // erasing the last tip of a pool
+  tips.Erase(3);
+  BOOST_CHECK((getPool(tips.GetEligible()) == std::set<RecordId>{0, 2}));
+
+  tips.Insert(1, false);
+  tips.Erase(0);
+  tips.Erase(2);
+  BOOST_CHECK_EQUAL(tips.EligibleSize(), 0);
+  BOOST_CHECK_EQUAL(tips.size(), 1);
+  BOOST_CHECK(tips.Contains(1));
+}
+
+BOOST_AUTO_TEST_CASE(TipSetSampleEligible)
+{
+  auto random = CreateObject<UniformRandomVariable>();
+  TipSet tips;
+  for (RecordId id = 0; id != 20; id++) {
+    tips.Insert(id, id % 2 == 0);
+  }
+  auto eligible = getPool(tips.GetEligible());
+
+  for (int i = 0; i != 100; i++) {
+    auto sampled = tips.SampleEligible(4, random);
+    BOOST_CHECK_EQUAL(sampled.size(), 4);
+    std::set<RecordId> distinct(sampled.begin(), sampled.end());
+    BOOST_CHECK_EQUAL(distinct.size(), sampled.size());
+    for (auto id : sampled) {
+      BOOST_CHECK(eligible.count(id) > 0);
+    }
+  }
+
+  // more than the eligible tips
+  auto sampled = tips.SampleEligible(100, random);
+  BOOST_CHECK((std::set<RecordId>(sampled.begin(), sampled.end()) == eligible));
+  BOOST_CHECK_EQUAL(sampled.size(), eligible.size());
+
+  // sampling reorders the pool, the positions must follow
+  for (RecordId id = 0; id != 20; id += 4) {
+    tips.Erase(id);
+    eligible.erase(id);
+  }
+  BOOST_CHECK(getPool(tips.GetEligible()) == eligible);
+  BOOST_CHECK_EQUAL(tips.size(), 15);
+
+  BOOST_CHECK(TipSet().SampleEligible(2, random).empty());
+}
+
+BOOST_AUTO_TEST_CASE(ApproverSetOverflow)
+{
+  const uint32_t lastInline = ApproverSet::INLINE_ORDINALS - 1;
+  const uint32_t firstOverflow = ApproverSet::INLINE_ORDINALS;
+
+  ApproverSet approvers;
+  BOOST_CHECK(approvers.Insert(0));
+  BOOST_CHECK(approvers.Insert(lastInline));
+  BOOST_CHECK(approvers.Insert(firstOverflow));
+  BOOST_CHECK(approvers.Insert(1000));
+  BOOST_CHECK_EQUAL(approvers.size(), 4);
+
+  // duplicates on either side of the boundary are not counted twice
+  BOOST_CHECK(!approvers.Insert(lastInline));
+  BOOST_CHECK(!approvers.Insert(firstOverflow));
+  BOOST_CHECK_EQUAL(approvers.size(), 4);
+
+  BOOST_CHECK(approvers.Contains(lastInline));
+  BOOST_CHECK(approvers.Contains(firstOverflow));
+  BOOST_CHECK(!approvers.Contains(lastInline - 1));
+  BOOST_CHECK(!approvers.Contains(firstOverflow + 1));
+
+  auto ordinals = approvers.GetOrdinals();
+  BOOST_REQUIRE_EQUAL(ordinals.size(), 4);
+  BOOST_CHECK_EQUAL(ordinals[0], 0);
+  BOOST_CHECK_EQUAL(ordinals[1], lastInline);
+  std::sort(ordinals.begin() + 2, ordinals.end());
+  BOOST_CHECK_EQUAL(ordinals[2], firstOverflow);
+  BOOST_CHECK_EQUAL(ordinals[3], 1000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
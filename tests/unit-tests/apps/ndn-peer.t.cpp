@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/ndn-peer.hpp"
+#include "helper/ndn-link-control-helper.hpp"
+#include "helper/ndn-strategy-choice-helper.hpp"
+#include "NFD/core/scheduler.hpp"
+
+#include <map>
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class PeerFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  PeerFixture()
+  {
+    // setting default parameters for PointToPoint links and channels
+    Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+    Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+    Config::SetDefault("ns3::QueueBase::MaxSize",
+                       QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, 20)));
+
+    createTopology({
+        {"A", "B"},
+        {"B", "C"}
+      });
+
+    addRoutes({
+        {"A", "B", "/dledger", 1},
+        {"B", "A", "/dledger", 1},
+        {"B", "C", "/dledger", 1},
+        {"C", "B", "/dledger", 1},
+      });
+
+    StrategyChoiceHelper::InstallAll("/dledger", "/localhost/nfd/strategy/multicast");
+  }
+
+  // one peer on each node, with the given attributes on top of the prefixes
+  void
+  addPeers(std::initializer_list<std::pair<std::string, std::string>> attributes)
+  {
+    for (const std::string node : {"A", "B", "C"}) {
+      addApps({
+          {node, "Peer", {{"Routable-Prefix", "/dledger/" + node}, {"Multicast-Prefix", "/dledger"}},
+           "0s", "100s"}
+        });
+      for (const auto& attribute : attributes) {
+        getPeer(node)->SetAttribute(attribute.first, StringValue(attribute.second));
+      }
+    }
+  }
+
+  Ptr<Peer>
+  getPeer(const std::string& node)
+  {
+    return DynamicCast<Peer>(getNode(node)->GetApplication(0));
+  }
+
+  // keeps the last value of a traced counter of the peer, as counters["node/counter"]
+  void
+  watchCounter(const std::string& node, const std::string& counter)
+  {
+    getPeer(node)->TraceConnect(counter, node + "/" + counter,
+                                MakeCallback(&PeerFixture::OnCounter, this));
+  }
+
+  void
+  OnCounter(std::string context, uint32_t oldValue, uint32_t newValue)
+  {
+    counters[context] = newValue;
+  }
+
+public:
+  std::map<std::string, uint32_t> counters;
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsNdnPeer, PeerFixture)
+
+BOOST_AUTO_TEST_CASE(SingleReferredRecord)
+{
+  // records still approve at least two tips
+  addPeers({{"ReferredNum", "1"}});
+
+  Simulator::Stop(Seconds(5));
+  Simulator::Run();
+
+  for (const std::string node : {"A", "B", "C"}) {
+    const auto& ledger = getPeer(node)->GetLedger();
+    BOOST_CHECK_GT(ledger.size(), 5); // more than the genesis records
+    for (const auto& record : ledger) {
+      BOOST_CHECK(record.approvals.empty() || record.approvals.size() >= 2);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CatchUpAfterPartition)
+{
+  addPeers({{"CatchUpThreshold", "4"}});
+  watchCounter("C", "CatchUpsStarted");
+  watchCounter("C", "RecordsCaughtUp");
+
+  // C misses the records A and B generate while its link is down
+  Simulator::Schedule(Seconds(2), ndn::LinkControlHelper::FailLink, getNode("B"), getNode("C"));
+  Simulator::Schedule(Seconds(8), ndn::LinkControlHelper::UpLink, getNode("B"), getNode("C"));
+
+  std::vector<Name> recordsOfA;
+  nfd::scheduler::schedule(time::seconds(8), [&] {
+      for (const auto& record : getPeer("A")->GetLedger()) {
+        recordsOfA.push_back(record.block->getName());
+      }
+      BOOST_CHECK_GT(recordsOfA.size(), getPeer("C")->GetLedger().size());
+    });
+
+  Simulator::Stop(Seconds(14));
+  Simulator::Run();
+
+  BOOST_CHECK_GT(counters["C/CatchUpsStarted"], 0);
+  BOOST_CHECK_GT(counters["C/RecordsCaughtUp"], 0);
+
+  // the ledger of C has every record A had when the link came back up
+  const auto& ledgerOfC = getPeer("C")->GetLedger();
+  for (const auto& name : recordsOfA) {
+    BOOST_CHECK_MESSAGE(ledgerOfC.find(name) != INVALID_RECORD_ID, name << " missing on C");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SyncReplySuppression)
+{
+  // A and B generate once, at the start, and sync every 20s
+  addPeers({{"GenesisNum", "2"}, {"Frequency", "0.01"}, {"SyncFrequency", "0.05"},
+            {"SyncReplyDelay", "1s"}});
+  // C, the identity manager, generates nothing and keeps advertising the genesis records,
+  // which A and B approved while its link was down
+  getPeer("C")->SetAttribute("Identity-Manager-Prefix", StringValue("/dledger/C"));
+  getPeer("C")->SetAttribute("SyncFrequency", StringValue("0.1"));
+  for (const std::string node : {"A", "B", "C"}) {
+    watchCounter(node, "SyncRepliesSent");
+    watchCounter(node, "SyncRepliesSuppressed");
+  }
+
+  Simulator::Schedule(Seconds(0), ndn::LinkControlHelper::FailLink, getNode("B"), getNode("C"));
+  Simulator::Schedule(Seconds(5), ndn::LinkControlHelper::UpLink, getNode("B"), getNode("C"));
+
+  // the stale SYNC of C at 10s is the only one before 20s; B, one hop closer, replies first
+  Simulator::Stop(Seconds(15));
+  Simulator::Run();
+
+  uint32_t nSent = 0;
+  uint32_t nSuppressed = 0;
+  for (const std::string node : {"A", "B", "C"}) {
+    nSent += counters[node + "/SyncRepliesSent"];
+    nSuppressed += counters[node + "/SyncRepliesSuppressed"];
+  }
+  BOOST_CHECK_EQUAL(nSent, 1);
+  BOOST_CHECK_EQUAL(counters["B/SyncRepliesSent"], 1);
+  BOOST_CHECK_GT(nSuppressed, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/ndn-record-content.hpp"
+
+#include <ndn-cxx/util/sha256.hpp>
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(AppsNdnRecordContent)
+
+// /dledger/<producer>/<64 hex digits, all equal to hexDigit>
+static Name
+makeRecordName(const std::string& producer, char hexDigit)
+{
+  return Name("/dledger").append(name::Component(producer))
+                         .append(name::Component(std::string(64, hexDigit)));
+}
+
+// Appends a TLV whose type and length fit in one octet
+static void
+appendTlv(std::vector<uint8_t>& wire, uint8_t type, const std::vector<uint8_t>& value)
+{
+  wire.push_back(type);
+  wire.push_back(static_cast<uint8_t>(value.size()));
+  wire.insert(wire.end(), value.begin(), value.end());
+}
+
+// Value of a digest list with one edge: count, the producer component, then the digest
+static std::vector<uint8_t>
+makeDigestList(uint8_t count, uint8_t componentLength, size_t producerOctets)
+{
+  std::vector<uint8_t> value{count, ::ndn::tlv::NameComponent, componentLength};
+  value.insert(value.end(), producerOctets, 'p');
+  value.insert(value.end(), sizeof(RecordDigest), 0xAB);
+  return value;
+}
+
+static Block
+makeContent(uint8_t version, const std::vector<uint8_t>& approvals, bool hasPayloadType = true)
+{
+  std::vector<uint8_t> value;
+  appendTlv(value, tlv_dledger::Version, {version});
+  appendTlv(value, tlv_dledger::Approvals, approvals);
+  if (hasPayloadType) {
+    appendTlv(value, tlv_dledger::PayloadType, {RecordContent::APP_DATA});
+  }
+  return ::ndn::encoding::makeBinaryBlock(::ndn::tlv::Content, value.data(), value.size());
+}
+
+BOOST_AUTO_TEST_CASE(RecordContentRoundTrip)
+{
+  RecordContent content;
+  content.AddApproval(makeRecordName("node1", 'a'));
+  content.AddApproval(makeRecordName("node2", '7'));
+  content.payloadType = RecordContent::REVOCATION;
+  content.payload = "/dledger/node3";
+
+  RecordContent decoded;
+  BOOST_REQUIRE(decoded.WireDecode(content.WireEncode()));
+  BOOST_REQUIRE_EQUAL(decoded.approvals.size(), 2);
+  for (size_t i = 0; i != 2; i++) {
+    BOOST_CHECK_EQUAL(decoded.approvals[i].producer, content.approvals[i].producer);
+    BOOST_CHECK(decoded.approvals[i].digest == content.approvals[i].digest);
+  }
+  BOOST_CHECK_EQUAL(decoded.approvals[0].producer, name::Component("node1"));
+  BOOST_CHECK_EQUAL(decoded.approvals[1].digest[0], 0x77);
+  BOOST_CHECK_EQUAL(decoded.payloadType, RecordContent::REVOCATION);
+  BOOST_CHECK_EQUAL(decoded.payload, content.payload);
+
+  // no Payload element without a payload
+  content.payload.clear();
+  content.payloadType = RecordContent::APP_DATA;
+  BOOST_REQUIRE(decoded.WireDecode(content.WireEncode()));
+  BOOST_CHECK_EQUAL(decoded.approvals.size(), 2);
+  BOOST_CHECK_EQUAL(decoded.payloadType, RecordContent::APP_DATA);
+  BOOST_CHECK(decoded.payload.empty());
+}
+
+BOOST_AUTO_TEST_CASE(RecordContentGenesis)
+{
+  RecordContent decoded;
+  decoded.AddApproval(makeRecordName("node1", 'a'));
+  decoded.payload = "stale";
+
+  BOOST_CHECK(decoded.WireDecode(Block(::ndn::tlv::Content)));
+  BOOST_CHECK(decoded.approvals.empty());
+  BOOST_CHECK(decoded.payload.empty());
+}
+
+BOOST_AUTO_TEST_CASE(RecordContentVersionMismatch)
+{
+  RecordContent decoded;
+  BOOST_CHECK(decoded.WireDecode(makeContent(RecordContent::VERSION, makeDigestList(1, 5, 5))));
+  BOOST_CHECK(!decoded.WireDecode(makeContent(RecordContent::VERSION + 1, makeDigestList(1, 5, 5))));
+}
+
+BOOST_AUTO_TEST_CASE(RecordContentMalformed)
+{
+  RecordContent decoded;
+
+  // missing elements
+  BOOST_CHECK(!decoded.WireDecode(makeContent(RecordContent::VERSION, makeDigestList(1, 5, 5),
+                                              false)));
+  std::vector<uint8_t> noApprovals;
+  appendTlv(noApprovals, tlv_dledger::Version, {RecordContent::VERSION});
+  appendTlv(noApprovals, tlv_dledger::PayloadType, {RecordContent::APP_DATA});
+  BOOST_CHECK(!decoded.WireDecode(::ndn::encoding::makeBinaryBlock(::ndn::tlv::Content,
+                                                                   noApprovals.data(),
+                                                                   noApprovals.size())));
+
+  // more edges announced than the list holds
+  BOOST_CHECK(!decoded.WireDecode(makeContent(RecordContent::VERSION, makeDigestList(2, 5, 5))));
+
+  // a producer component running into the digest, so the digest is cut short
+  BOOST_CHECK(!decoded.WireDecode(makeContent(RecordContent::VERSION, makeDigestList(1, 10, 5))));
+
+  // a producer component that is not a NameComponent
+  auto wrongType = makeDigestList(1, 5, 5);
+  wrongType[1] = ::ndn::tlv::Name;
+  BOOST_CHECK(!decoded.WireDecode(makeContent(RecordContent::VERSION, wrongType)));
+
+  // octets left after the last edge
+  auto trailing = makeDigestList(1, 5, 5);
+  trailing.push_back(0);
+  BOOST_CHECK(!decoded.WireDecode(makeContent(RecordContent::VERSION, trailing)));
+
+  // a list ending right after its count
+  BOOST_CHECK(!decoded.WireDecode(makeContent(RecordContent::VERSION, {1})));
+  BOOST_CHECK(decoded.WireDecode(makeContent(RecordContent::VERSION, {0})));
+  BOOST_CHECK(decoded.approvals.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SyncStateRoundTrip)
+{
+  SyncState state;
+  state.AddTip(makeRecordName("node1", 'a'));
+  state.AddTip(makeRecordName("node2", '7'));
+  state.AddTip(Name("/dledger/node3/not-a-digest")); // ignored
+
+  // the state travels as the last component of the SYNC Interest name
+  Name syncName("/dledger/SYNC");
+  syncName.append(state.WireEncode());
+
+  SyncState decoded;
+  BOOST_REQUIRE(decoded.WireDecode(syncName.get(-1)));
+  BOOST_REQUIRE_EQUAL(decoded.tips.size(), 2);
+  for (size_t i = 0; i != 2; i++) {
+    BOOST_CHECK_EQUAL(decoded.tips[i].producer, state.tips[i].producer);
+    BOOST_CHECK(decoded.tips[i].digest == state.tips[i].digest);
+  }
+
+  BOOST_REQUIRE(decoded.WireDecode(SyncState().WireEncode()));
+  BOOST_CHECK(decoded.tips.empty());
+}
+
+// SyncState TLV around a digest list value
+static name::Component
+makeSyncState(const std::vector<uint8_t>& tips)
+{
+  std::vector<uint8_t> wire;
+  appendTlv(wire, tlv_dledger::SyncState, tips);
+  return name::Component(wire.data(), wire.size());
+}
+
+BOOST_AUTO_TEST_CASE(SyncStateMalformed)
+{
+  SyncState decoded;
+  BOOST_CHECK(decoded.WireDecode(makeSyncState(makeDigestList(1, 5, 5))));
+  BOOST_CHECK_EQUAL(decoded.tips.size(), 1);
+
+  // not a SyncState
+  auto content = makeContent(RecordContent::VERSION, makeDigestList(1, 5, 5));
+  BOOST_CHECK(!decoded.WireDecode(name::Component(content.wire(), content.size())));
+  BOOST_CHECK(decoded.tips.empty());
+
+  // a component cut short of the TLV it carries
+  SyncState state;
+  state.AddTip(makeRecordName("node1", 'a'));
+  auto full = state.WireEncode();
+  BOOST_CHECK(!decoded.WireDecode(name::Component(full.value(), full.value_size() - 1)));
+
+  // malformed digest lists
+  BOOST_CHECK(!decoded.WireDecode(makeSyncState(makeDigestList(2, 5, 5))));
+  BOOST_CHECK(!decoded.WireDecode(makeSyncState(makeDigestList(1, 10, 5))));
+  auto trailing = makeDigestList(1, 5, 5);
+  trailing.push_back(0);
+  BOOST_CHECK(!decoded.WireDecode(makeSyncState(trailing)));
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointRoundTrip)
+{
+  Checkpoint checkpoint;
+  checkpoint.AddFrontier(makeRecordName("node1", 'a'));
+  checkpoint.AddFrontier(makeRecordName("node2", '7'));
+  checkpoint.merkleRoot.fill(0x5A);
+
+  Checkpoint decoded;
+  BOOST_REQUIRE(decoded.WireDecode(checkpoint.WireEncode()));
+  BOOST_REQUIRE_EQUAL(decoded.frontier.size(), 2);
+  for (size_t i = 0; i != 2; i++) {
+    BOOST_CHECK_EQUAL(decoded.frontier[i].producer, checkpoint.frontier[i].producer);
+    BOOST_CHECK(decoded.frontier[i].digest == checkpoint.frontier[i].digest);
+  }
+  BOOST_CHECK(decoded.merkleRoot == checkpoint.merkleRoot);
+
+  auto wire = checkpoint.WireEncode();
+  BOOST_CHECK(!decoded.WireDecode(wire.substr(0, wire.size() - 1)));
+  BOOST_CHECK(!decoded.WireDecode(""));
+  auto content = RecordContent().WireEncode();
+  BOOST_CHECK(!decoded.WireDecode(std::string(reinterpret_cast<const char*>(content.wire()),
+                                              content.size())));
+}
+
+static RecordDigest
+hashPair(const RecordDigest& left, const RecordDigest& right)
+{
+  ::ndn::util::Sha256 sha;
+  sha.update(left.data(), left.size());
+  sha.update(right.data(), right.size());
+  auto parent = sha.computeDigest();
+  RecordDigest digest;
+  std::copy(parent->begin(), parent->end(), digest.begin());
+  return digest;
+}
+
+BOOST_AUTO_TEST_CASE(MerkleRoot)
+{
+  RecordDigest d1, d2, d3;
+  d1.fill(1);
+  d2.fill(2);
+  d3.fill(3);
+
+  RecordDigest zeros{};
+  BOOST_CHECK(Checkpoint::ComputeMerkleRoot({}) == zeros);
+  BOOST_CHECK(Checkpoint::ComputeMerkleRoot({d2}) == d2);
+
+  // leaves are sorted, so the order of the digests does not matter
+  BOOST_CHECK(Checkpoint::ComputeMerkleRoot({d2, d1}) == hashPair(d1, d2));
+  BOOST_CHECK(Checkpoint::ComputeMerkleRoot({d1, d2}) == hashPair(d1, d2));
+
+  // the odd leaf is carried up to be paired at the next level
+  BOOST_CHECK(Checkpoint::ComputeMerkleRoot({d3, d1, d2}) == hashPair(hashPair(d1, d2), d3));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -99,6 +99,39 @@ BOOST_AUTO_TEST_CASE(Helper4)
 
 BOOST_AUTO_TEST_SUITE_END() // AddRoute
 
+BOOST_FIXTURE_TEST_CASE(ForwardingOnly, ScenarioHelperWithCleanupFixture)
+{
+  setForwardingOnly();
+  createTopology({
+      {"1", "2"}
+    });
+
+  addApps({
+      {"1", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "1"}},
+          "0s", "9.99s"},
+      {"2", "ns3::ndn::Producer",
+          {{"Prefix", "/prefix"}, {"PayloadSize", "1024"}},
+          "0s", "100s"}
+    });
+
+  // without management, routes are written to the FIB directly
+  FibHelper::AddRoute(getNode("1"), Name("/prefix"), getFace("1", "2"), 1);
+  FibHelper::AddRoute(getNode("1"), Name("/other"), getFace("1", "2"), 1);
+  FibHelper::RemoveRoute(getNode("1"), Name("/other"), getFace("1", "2"));
+
+  auto& fib = getNode("1")->GetObject<L3Protocol>()->getForwarder()->getFib();
+  BOOST_CHECK(fib.findExactMatch("/prefix") != nullptr);
+  BOOST_CHECK(fib.findExactMatch("/other") == nullptr);
+  BOOST_CHECK(fib.findExactMatch("/localhost/nfd") == nullptr);
+
+  Simulator::Stop(Seconds(20.001));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("1", "2")->getCounters().nOutInterests, 10);
+  BOOST_CHECK_EQUAL(getFace("1", "2")->getCounters().nInData, 10);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // HelperNdnFibHelper
 
 } // namespace ndn
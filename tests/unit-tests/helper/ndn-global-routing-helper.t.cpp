@@ -18,6 +18,7 @@
  **/
 
 #include "helper/ndn-global-routing-helper.hpp"
+#include "helper/ndn-link-control-helper.hpp"
 #include "helper/ndn-stack-helper.hpp"
 
 #include "model/ndn-global-router.hpp"
@@ -190,6 +191,149 @@ BOOST_AUTO_TEST_CASE(CalculateRoutesBasedOnLinkDelay)
   }
 }
 
+static std::string
+dumpFibs()
+{
+  std::ostringstream os;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    auto ndn = (*node)->GetObject<ndn::L3Protocol>();
+    for (const auto& entry : ndn->getForwarder()->getFib()) {
+      os << (*node)->GetId() << " " << entry.getPrefix();
+      for (const auto& nextHop : entry.getNextHops()) {
+        os << " " << nextHop.getFace().getId() << ":" << nextHop.getCost();
+      }
+      os << "\n";
+    }
+  }
+  return os.str();
+}
+
+// Removes the next hops over links, which are the ones global routing installs
+static void
+clearFibs()
+{
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    auto ndn = (*node)->GetObject<ndn::L3Protocol>();
+    auto& fib = ndn->getForwarder()->getFib();
+
+    std::vector<std::pair<Name, nfd::FaceId>> routes;
+    for (const auto& entry : fib) {
+      for (const auto& nextHop : entry.getNextHops()) {
+        if (dynamic_cast<NetDeviceTransport*>(nextHop.getFace().getTransport()) != nullptr) {
+          routes.push_back(std::make_pair(entry.getPrefix(), nextHop.getFace().getId()));
+        }
+      }
+    }
+    for (const auto& route : routes) {
+      // erases the entry together with its last next hop
+      fib.removeNextHop(*fib.findExactMatch(route.first), *ndn->getFaceById(route.second));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelCalculationMatchesSerial)
+{
+  PointToPointHelper p2p;
+  PointToPointGridHelper grid(6, 6, p2p);
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    ndnGlobalRoutingHelper.AddOrigin("/node" + std::to_string((*node)->GetId()), *node);
+  }
+
+  // equal metrics on a grid give many equal-cost paths, so ties must break the same way
+  ndn::GlobalRoutingHelper::SetRouteCalculationThreads(1);
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+  std::string serialFibs = dumpFibs();
+  BOOST_CHECK(!serialFibs.empty());
+
+  // each calculation starts from empty FIBs, so a route missed by one is not masked by the other
+  clearFibs();
+  BOOST_CHECK_NE(dumpFibs(), serialFibs);
+  ndn::GlobalRoutingHelper::SetRouteCalculationThreads(4);
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+  BOOST_CHECK_EQUAL(dumpFibs(), serialFibs);
+
+  clearFibs();
+  ndn::GlobalRoutingHelper::SetRouteCalculationThreads(1);
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes();
+  std::string serialAllFibs = dumpFibs();
+
+  clearFibs();
+  ndn::GlobalRoutingHelper::SetRouteCalculationThreads(4);
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes();
+  BOOST_CHECK_EQUAL(dumpFibs(), serialAllFibs);
+
+  ndn::GlobalRoutingHelper::SetRouteCalculationThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalUpdateOnLinkChange)
+{
+  // ring of 5 nodes, so every shortest path is unique
+  NodeContainer nodes;
+  nodes.Create(5);
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+    p2p.Install(nodes.Get(i), nodes.Get((i + 1) % nodes.GetN()));
+  }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+  for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+    ndnGlobalRoutingHelper.AddOrigin("/node" + std::to_string(i), nodes.Get(i));
+  }
+
+  ndn::GlobalRoutingHelper::SetIncrementalRouting(true);
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+  std::string initialFibs = dumpFibs();
+
+  auto getNextHops = [&nodes] (uint32_t node, const Name& prefix) {
+    auto& fib = nodes.Get(node)->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+    std::vector<std::pair<uint32_t, uint64_t>> nextHops; // (neighbor, cost)
+    auto entry = fib.findExactMatch(prefix);
+    if (entry != nullptr) {
+      for (const auto& nextHop : entry->getNextHops()) {
+        auto transport = dynamic_cast<NetDeviceTransport*>(nextHop.getFace().getTransport());
+        auto channel = transport->GetNetDevice()->GetChannel();
+        auto neighbor = channel->GetDevice(0)->GetNode();
+        if (neighbor == nodes.Get(node)) {
+          neighbor = channel->GetDevice(1)->GetNode();
+        }
+        nextHops.push_back(std::make_pair(neighbor->GetId(), nextHop.getCost()));
+      }
+    }
+    return nextHops;
+  };
+
+  typedef std::vector<std::pair<uint32_t, uint64_t>> NextHops;
+  BOOST_CHECK(getNextHops(0, "/node1") == (NextHops{{1, 1}}));
+  BOOST_CHECK(getNextHops(0, "/node3") == (NextHops{{4, 2}}));
+
+  // the route to /node1 now goes around the ring, and routes not using the link are unchanged
+  LinkControlHelper::FailLink(nodes.Get(0), nodes.Get(1));
+  BOOST_CHECK(getNextHops(0, "/node1") == (NextHops{{4, 4}}));
+  BOOST_CHECK(getNextHops(1, "/node0") == (NextHops{{2, 4}}));
+  BOOST_CHECK(getNextHops(0, "/node3") == (NextHops{{4, 2}}));
+  BOOST_CHECK(getNextHops(2, "/node0") == (NextHops{{3, 3}}));
+
+  // a full recalculation excludes the failed link as well
+  std::string failedFibs = dumpFibs();
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+  BOOST_CHECK_EQUAL(dumpFibs(), failedFibs);
+
+  LinkControlHelper::UpLink(nodes.Get(0), nodes.Get(1));
+  BOOST_CHECK_EQUAL(dumpFibs(), initialFibs);
+
+  ndn::GlobalRoutingHelper::SetIncrementalRouting(false);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
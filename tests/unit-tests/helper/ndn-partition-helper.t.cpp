@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "helper/ndn-partition-helper.hpp"
+
+#include "ns3/names.h"
+#include "ns3/node.h"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_FIXTURE_TEST_SUITE(HelperNdnPartitionHelper, CleanupFixture)
+
+BOOST_AUTO_TEST_CASE(LineTopology)
+{
+  PartitionHelper partitioner;
+  partitioner.AddNodes(40);
+  for (uint32_t i = 0; i < 39; ++i) {
+    partitioner.AddLink(i, i + 1, MilliSeconds(10));
+  }
+  partitioner.Partition(4);
+
+  // a line splits into contiguous segments
+  BOOST_CHECK_EQUAL(partitioner.GetCutSize(), 3);
+  for (uint32_t rank = 0; rank < 4; ++rank) {
+    BOOST_CHECK_EQUAL(partitioner.GetNNodes(rank), 10);
+    BOOST_CHECK_EQUAL(partitioner.GetLookahead(rank), MilliSeconds(10));
+  }
+
+  NodeContainer nodes = partitioner.CreateNodes();
+  BOOST_REQUIRE_EQUAL(nodes.GetN(), 40);
+  for (uint32_t i = 0; i < 40; ++i) {
+    BOOST_CHECK_EQUAL(nodes.Get(i)->GetSystemId(), partitioner.GetSystemId(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TwoClusters)
+{
+  // two 8-node cliques joined by a single slow link
+  PartitionHelper partitioner;
+  for (int i = 0; i < 16; ++i) {
+    partitioner.AddNode("n" + std::to_string(i));
+  }
+  for (int c = 0; c < 2; ++c) {
+    for (int i = 0; i < 8; ++i) {
+      for (int j = i + 1; j < 8; ++j) {
+        partitioner.AddLink(c * 8 + i, c * 8 + j, MilliSeconds(1));
+      }
+    }
+  }
+  partitioner.AddLink("n0", "n8", MilliSeconds(50));
+  partitioner.Partition(2);
+
+  BOOST_CHECK_EQUAL(partitioner.GetCutSize(), 1);
+  BOOST_CHECK_NE(partitioner.GetSystemId("n0"), partitioner.GetSystemId("n8"));
+  BOOST_CHECK_EQUAL(partitioner.GetLookahead(0), MilliSeconds(50));
+  BOOST_CHECK_EQUAL(partitioner.GetLookahead(1), MilliSeconds(50));
+
+  auto systemIds = partitioner.GetSystemIds();
+  BOOST_CHECK_EQUAL(systemIds.size(), 16);
+  for (int i = 0; i < 8; ++i) {
+    BOOST_CHECK_EQUAL(systemIds["n" + std::to_string(i)], systemIds["n0"]);
+    BOOST_CHECK_EQUAL(systemIds["n" + std::to_string(i + 8)], systemIds["n8"]);
+  }
+
+  partitioner.CreateNodes();
+  BOOST_CHECK(Names::Find<Node>("n3") != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(GridBalance)
+{
+  const uint32_t width = 20;
+  PartitionHelper partitioner;
+  partitioner.AddNodes(width * width);
+  for (uint32_t i = 0; i < width; ++i) {
+    for (uint32_t j = 0; j < width; ++j) {
+      if (j + 1 < width) {
+        partitioner.AddLink(i * width + j, i * width + j + 1, MilliSeconds(10));
+      }
+      if (i + 1 < width) {
+        partitioner.AddLink(i * width + j, (i + 1) * width + j, MilliSeconds(10));
+      }
+    }
+  }
+  partitioner.Partition(4);
+
+  // within the 5% imbalance, and far below the ~700 links cut by round-robin assignment
+  for (uint32_t rank = 0; rank < 4; ++rank) {
+    BOOST_CHECK_LE(partitioner.GetNNodes(rank), 105);
+  }
+  BOOST_CHECK_LT(partitioner.GetCutSize(), 80);
+}
+
+BOOST_AUTO_TEST_CASE(NoCutLinks)
+{
+  PartitionHelper partitioner;
+  partitioner.AddNodes(3);
+  partitioner.AddLink(0, 1, MilliSeconds(10));
+  partitioner.Partition(1);
+
+  BOOST_CHECK_EQUAL(partitioner.GetCutSize(), 0);
+  BOOST_CHECK_EQUAL(partitioner.GetNNodes(0), 3);
+  BOOST_CHECK_EQUAL(partitioner.GetLookahead(0), Time::Max());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
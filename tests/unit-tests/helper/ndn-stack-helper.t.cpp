@@ -22,6 +22,8 @@
 
 #include "ns3/point-to-point-module.h"
 
+#include "ns3/ndnSIM/NFD/daemon/table/cs-policy-lru.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -63,6 +65,35 @@ BOOST_AUTO_TEST_CASE(TestNfdContentStorePolicy)
   BOOST_CHECK_EQUAL(protoNode1->getForwarder()->getCs().getPolicy()->getName(), "priority_fifo");
 }
 
+BOOST_AUTO_TEST_CASE(TestSharedNfdConfig)
+{
+  NodeContainer nodes;
+  nodes.Create(4);
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(10);
+  ndnHelper.Install(nodes.Get(0));
+  ndnHelper.Install(nodes.Get(1));
+
+  // a parameter change applies to the stacks installed afterwards only
+  ndnHelper.setCsSize(20);
+  ndnHelper.Install(nodes.Get(2));
+
+  BOOST_CHECK_EQUAL(L3Protocol::getL3Protocol(nodes.Get(0))->getForwarder()->getCs().getLimit(), 10);
+  BOOST_CHECK_EQUAL(L3Protocol::getL3Protocol(nodes.Get(1))->getForwarder()->getCs().getLimit(), 10);
+  BOOST_CHECK_EQUAL(L3Protocol::getL3Protocol(nodes.Get(2))->getForwarder()->getCs().getLimit(), 20);
+
+  // an override applies to its stack only
+  Ptr<L3Protocol> ndn = CreateObject<L3Protocol>();
+  ndn->setCsReplacementPolicy([] { return make_unique<nfd::cs::LruPolicy>(); });
+  ndn->overrideConfig("tables.cs_max_packets", "5");
+  ndn->overrideConfig("ndnSIM.disable_rib_manager", "true");
+  nodes.Get(3)->AggregateObject(ndn);
+
+  BOOST_CHECK_EQUAL(ndn->getForwarder()->getCs().getLimit(), 5);
+  BOOST_CHECK_EQUAL(L3Protocol::getDefaultConfig()->get<size_t>("tables.cs_max_packets"), 100);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
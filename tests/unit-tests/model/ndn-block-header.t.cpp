@@ -27,6 +27,11 @@
 
 #include "../tests-common.hpp"
 
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <chrono>
+
 namespace ns3 {
 namespace ndn {
 
@@ -155,6 +160,115 @@ BOOST_AUTO_TEST_CASE(PrintLpPacket)
   }
 }
 
+static nfd::face::Transport::Packet
+makeDataPacket(size_t payloadSize)
+{
+  Data data("/dledger/node1/record");
+  data.setContent(std::make_shared< ::ndn::Buffer>(payloadSize));
+  ndn::StackHelper::getKeyChain().sign(data);
+  return nfd::face::Transport::Packet(data.wireEncode());
+}
+
+BOOST_AUTO_TEST_CASE(DeserializeRoundTrip)
+{
+  for (size_t payloadSize : {0, 200, 1000, 70000}) { // 70000 needs a 4-octet TLV-LENGTH
+    auto nfdPacket = makeDataPacket(payloadSize);
+    BlockHeader header(nfdPacket);
+
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(header);
+
+    BlockHeader peeked;
+    BOOST_CHECK_EQUAL(packet->PeekHeader(peeked), nfdPacket.packet.size());
+    BOOST_CHECK(peeked.getBlock() == nfdPacket.packet);
+
+    BlockHeader removed;
+    BOOST_CHECK_EQUAL(packet->RemoveHeader(removed), nfdPacket.packet.size());
+    BOOST_CHECK(removed.getBlock() == nfdPacket.packet);
+    BOOST_CHECK_EQUAL(packet->GetSize(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DeserializeTruncated)
+{
+  auto nfdPacket = makeDataPacket(1000);
+  const Block& wire = nfdPacket.packet;
+
+  ns3::Buffer buffer;
+  buffer.AddAtStart(wire.size() - 1);
+  buffer.Begin().Write(wire.wire(), wire.size() - 1);
+
+  BlockHeader header;
+  BOOST_CHECK_THROW(header.Deserialize(buffer.Begin()), ::ndn::tlv::Error);
+
+  ns3::Buffer empty;
+  BOOST_CHECK_THROW(header.Deserialize(empty.Begin()), ::ndn::tlv::Error);
+}
+
+// Byte-at-a-time stream source, the deserialization path BlockHeader used before the bulk read
+class ByteStreamSource : public boost::iostreams::source {
+public:
+  ByteStreamSource(ns3::Buffer::Iterator& is)
+    : m_is(is)
+  {
+  }
+
+  std::streamsize
+  read(char* buf, std::streamsize nMaxRead)
+  {
+    std::streamsize i = 0;
+    for (; i < nMaxRead && !m_is.IsEnd(); ++i) {
+      buf[i] = m_is.ReadU8();
+    }
+    return i == 0 ? -1 : i;
+  }
+
+private:
+  ns3::Buffer::Iterator& m_is;
+};
+
+BOOST_AUTO_TEST_CASE(DeserializeBenchmark)
+{
+  const int N_ITERATIONS = 2000;
+  auto nfdPacket = makeDataPacket(1400);
+  const Block& wire = nfdPacket.packet;
+
+  ns3::Buffer buffer;
+  buffer.AddAtStart(wire.size());
+  buffer.Begin().Write(wire.wire(), wire.size());
+
+  size_t checksum = 0;
+
+  auto streamStart = std::chrono::steady_clock::now();
+  for (int i = 0; i < N_ITERATIONS; ++i) {
+    ns3::Buffer::Iterator start = buffer.Begin();
+    boost::iostreams::stream<ByteStreamSource> is(start);
+    checksum += ::ndn::Block::fromStream(is).size();
+  }
+  auto streamTime = std::chrono::steady_clock::now() - streamStart;
+
+  auto bulkStart = std::chrono::steady_clock::now();
+  for (int i = 0; i < N_ITERATIONS; ++i) {
+    BlockHeader header;
+    checksum += header.Deserialize(buffer.Begin());
+  }
+  auto bulkTime = std::chrono::steady_clock::now() - bulkStart;
+
+  BOOST_CHECK_EQUAL(checksum, 2 * N_ITERATIONS * wire.size());
+
+  ns3::Buffer::Iterator start = buffer.Begin();
+  boost::iostreams::stream<ByteStreamSource> is(start);
+  BlockHeader header;
+  header.Deserialize(buffer.Begin());
+  BOOST_CHECK(::ndn::Block::fromStream(is) == header.getBlock());
+
+  using std::chrono::microseconds;
+  BOOST_TEST_MESSAGE("BlockHeader::Deserialize of " << wire.size() << "-octet Data x" << N_ITERATIONS
+                     << ": byte stream " << std::chrono::duration_cast<microseconds>(streamTime).count()
+                     << "us, bulk read " << std::chrono::duration_cast<microseconds>(bulkTime).count()
+                     << "us");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
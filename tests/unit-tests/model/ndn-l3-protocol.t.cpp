@@ -149,6 +149,17 @@ BOOST_AUTO_TEST_CASE(DisabledForwarderStatusManager)
                                 receivedDatasets.begin(), receivedDatasets.end());
 }
 
+BOOST_AUTO_TEST_CASE(ForwardingOnly)
+{
+  // no management plane, so no dataset can be retrieved
+  setForwardingOnly();
+
+  setupAndRun();
+
+  BOOST_CHECK_EQUAL(receivedDatasets.size(), 0);
+  BOOST_CHECK(getNode("1")->GetObject<L3Protocol>()->isForwardingOnly());
+}
+
 BOOST_AUTO_TEST_SUITE_END() // ManagerCheck
 
 BOOST_AUTO_TEST_SUITE_END() // ModelNdnL3Protocol
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/tracers/ndn-binary-trace.hpp"
+
+#include <sstream>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+static BinaryTraceSchema
+makeSchema()
+{
+  return {"Test", "Time\tNode\tSeqNo\tType\t",
+          {{BinaryTraceSchema::DOUBLE, "Time"},
+           {BinaryTraceSchema::STRING, "Node"},
+           {BinaryTraceSchema::INT, "SeqNo"},
+           {BinaryTraceSchema::STRING, "Type"}}};
+}
+
+BOOST_AUTO_TEST_SUITE(UtilsTracersNdnBinaryTrace)
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  BinaryTraceEncoder encoder(makeSchema());
+  std::ostringstream binary;
+  encoder.WriteSchema(binary);
+  encoder.AddDouble(0.5).AddString("node1").AddInt(-1).AddString("Hit").EndRow(binary);
+  encoder.AddDouble(1.25).AddString("node2").AddInt(1ll << 40).AddString("Hit").EndRow(binary);
+  encoder.AddDouble(2).AddString("node1").AddInt(3).AddString("Miss").EndRow(binary);
+
+  std::istringstream is(binary.str());
+  BinaryTraceReader reader(is);
+  BOOST_CHECK_EQUAL(reader.GetSchema().table, "Test");
+  BOOST_REQUIRE_EQUAL(reader.GetSchema().columns.size(), 4);
+  BOOST_CHECK_EQUAL(reader.GetSchema().columns[2].name, "SeqNo");
+  BOOST_CHECK_EQUAL(reader.GetSchema().columns[2].type, BinaryTraceSchema::INT);
+
+  BOOST_REQUIRE(reader.ReadRow());
+  BOOST_CHECK_EQUAL(reader.GetDouble(0), 0.5);
+  BOOST_CHECK_EQUAL(reader.GetString(1), "node1");
+  BOOST_CHECK_EQUAL(reader.GetInt(2), -1);
+  BOOST_CHECK_EQUAL(reader.GetString(3), "Hit");
+
+  BOOST_REQUIRE(reader.ReadRow());
+  BOOST_CHECK_EQUAL(reader.GetInt(2), 1ll << 40);
+
+  // the header is reproduced verbatim, including the trailing tab
+  std::ostringstream text;
+  reader.PrintText(text);
+  BOOST_CHECK_EQUAL(text.str(), "Time\tNode\tSeqNo\tType\t\n"
+                                "2\tnode1\t3\tMiss\n");
+  BOOST_CHECK(!reader.ReadRow());
+}
+
+BOOST_AUTO_TEST_CASE(StringsDefinedOnce)
+{
+  BinaryTraceEncoder encoder(makeSchema());
+  std::ostringstream first;
+  encoder.AddDouble(1).AddString("a-long-node-name").AddInt(1).AddString("Hit").EndRow(first);
+  std::ostringstream second;
+  encoder.AddDouble(2).AddString("a-long-node-name").AddInt(2).AddString("Hit").EndRow(second);
+
+  // the second row is only the tag and the fixed-width values
+  BOOST_CHECK_EQUAL(second.str().size(), 1 + 8 + 4 + 8 + 4);
+  BOOST_CHECK_GT(first.str().size(), second.str().size());
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  std::istringstream text("Time\tNode\n");
+  BOOST_CHECK_THROW(BinaryTraceReader reader(text), BinaryTraceReader::Error);
+
+  BinaryTraceEncoder encoder(makeSchema());
+  std::ostringstream binary;
+  encoder.WriteSchema(binary);
+  encoder.AddDouble(1).AddString("node1").AddInt(1).AddString("Hit").EndRow(binary);
+
+  std::string truncated = binary.str();
+  truncated.resize(truncated.size() - 1);
+  std::istringstream is(truncated);
+  BinaryTraceReader reader(is);
+  BOOST_CHECK_THROW(reader.ReadRow(), BinaryTraceReader::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -22,12 +22,17 @@
 #include <boost/filesystem.hpp>
 #include <boost/test/output_test_stream.hpp>
 
+#include <fstream>
+#include <sstream>
+
 #include "../../tests-common.hpp"
 
 namespace ns3 {
 namespace ndn {
 
 const boost::filesystem::path TEST_TRACE = boost::filesystem::path(TEST_CONFIG_PATH) / "trace.txt";
+const boost::filesystem::path TEST_BINARY_TRACE =
+  boost::filesystem::path(TEST_CONFIG_PATH) / "trace.bin";
 
 class L3RateTracerFixture : public ScenarioHelperWithCleanupFixture
 {
@@ -56,6 +61,7 @@ public:
   ~L3RateTracerFixture()
   {
     boost::filesystem::remove(TEST_TRACE);
+    boost::filesystem::remove(TEST_BINARY_TRACE);
     L3RateTracer::Destroy(); // additional cleanup
   }
 };
@@ -120,6 +126,33 @@ BOOST_AUTO_TEST_CASE(NackTracing)
   BOOST_CHECK(os.match_pattern());
 }
 
+BOOST_AUTO_TEST_CASE(BinaryFormat)
+{
+  NodeContainer nodes;
+  nodes.Add(getNode("1"));
+
+  L3RateTracer::Install(nodes, TEST_TRACE.string(), Seconds(1));
+  L3RateTracer::Install(nodes, TEST_BINARY_TRACE.string(), Seconds(1));
+
+  Simulator::Stop(Seconds(2.5));
+  Simulator::Run();
+
+  L3RateTracer::Destroy(); // to force log to be written
+
+  std::ifstream text(TEST_TRACE.string());
+  std::ostringstream expected;
+  expected << text.rdbuf();
+
+  std::ifstream binary(TEST_BINARY_TRACE.string(), std::ios_base::binary);
+  BinaryTraceReader reader(binary);
+  BOOST_CHECK_EQUAL(reader.GetSchema().table, "L3RateTracer");
+  BOOST_CHECK_EQUAL(reader.GetSchema().columns.size(), 9);
+
+  std::ostringstream converted;
+  reader.PrintText(converted);
+  BOOST_CHECK_EQUAL(converted.str(), expected.str());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
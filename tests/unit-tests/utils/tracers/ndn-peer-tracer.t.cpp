@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/tracers/ndn-peer-tracer.hpp"
+#include "apps/ndn-app.hpp"
+#include "helper/ndn-strategy-choice-helper.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+const boost::filesystem::path TEST_TRACE = boost::filesystem::path(TEST_CONFIG_PATH) / "peer.txt";
+
+class PeerTracerFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  PeerTracerFixture()
+  {
+    boost::filesystem::create_directories(TEST_CONFIG_PATH);
+
+    // setting default parameters for PointToPoint links and channels
+    Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+    Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+    Config::SetDefault("ns3::QueueBase::MaxSize",
+                       QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, 20)));
+
+    createTopology({
+        {"A", "B"},
+        {"B", "C"}
+      });
+
+    addRoutes({
+        {"A", "B", "/dledger", 1},
+        {"B", "A", "/dledger", 1},
+        {"B", "C", "/dledger", 1},
+        {"C", "B", "/dledger", 1},
+      });
+
+    StrategyChoiceHelper::InstallAll("/dledger", "/localhost/nfd/strategy/multicast");
+
+    addApps({
+        {"A", "Peer", {{"Routable-Prefix", "/dledger/A"}, {"Multicast-Prefix", "/dledger"},
+                       {"GenesisNum", "5"}, {"ReferredNum", "2"}}, "1s", "10s"},
+        {"B", "Peer", {{"Routable-Prefix", "/dledger/B"}, {"Multicast-Prefix", "/dledger"},
+                       {"GenesisNum", "5"}, {"ReferredNum", "2"}}, "1s", "10s"},
+        {"C", "Peer", {{"Routable-Prefix", "/dledger/C"}, {"Multicast-Prefix", "/dledger"},
+                       {"GenesisNum", "5"}, {"ReferredNum", "2"}}, "1s", "10s"}
+      });
+  }
+
+  ~PeerTracerFixture()
+  {
+    boost::filesystem::remove(TEST_TRACE);
+    PeerTracer::Destroy(); // additional cleanup
+  }
+
+  void
+  CountEvent(std::string context, Ptr<App> app, const RecordDigest& digest, RecordId record)
+  {
+    nEvents[context.substr(context.rfind('/') + 1)]++;
+  }
+
+  // reads the rows of the trace, after checking the header, as type => number of samples
+  std::map<std::string, int>
+  ReadSamples()
+  {
+    std::map<std::string, int> samples;
+
+    std::ifstream file(TEST_TRACE.string());
+    std::string line;
+    BOOST_REQUIRE(std::getline(file, line));
+    BOOST_CHECK_EQUAL(line, "Time\tNode\tType\tSamples\tP50\tP90\tP99\tMax");
+
+    while (std::getline(file, line)) {
+      std::istringstream row(line);
+      double time, p50, p90, p99, max;
+      std::string node, type;
+      int nSamples;
+      BOOST_REQUIRE(row >> time >> node >> type >> nSamples >> p50 >> p90 >> p99 >> max);
+      BOOST_CHECK_GT(nSamples, 0);
+      BOOST_CHECK(0 <= p50 && p50 <= p90 && p90 <= p99 && p99 <= max);
+      samples[type] += nSamples;
+    }
+    return samples;
+  }
+
+public:
+  std::map<std::string, int> nEvents;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTracersNdnPeerTracer, PeerTracerFixture)
+
+BOOST_AUTO_TEST_CASE(Lifecycle)
+{
+  Config::Connect("/NodeList/*/ApplicationList/*/RecordGenerated",
+                  MakeCallback(&PeerTracerFixture::CountEvent, this));
+  Config::Connect("/NodeList/*/ApplicationList/*/RecordAdmitted",
+                  MakeCallback(&PeerTracerFixture::CountEvent, this));
+
+  PeerTracer::InstallAll(TEST_TRACE.string(), Seconds(1));
+
+  Simulator::Stop(Seconds(10));
+  Simulator::Run();
+
+  PeerTracer::Destroy(); // to force log to be written
+
+  BOOST_CHECK_GT(nEvents["RecordGenerated"], 0);
+  // every peer admits its genesis records, its own records and the records of the others
+  BOOST_CHECK_GT(nEvents["RecordAdmitted"], nEvents["RecordGenerated"]);
+
+  auto samples = ReadSamples();
+  BOOST_CHECK_GT(samples["Propagation"], 0);
+  BOOST_CHECK_LE(samples["Propagation"], 2 * nEvents["RecordGenerated"]);
+  BOOST_CHECK_EQUAL(samples["Pushed"], 0);
+}
+
+BOOST_AUTO_TEST_CASE(PushedRecords)
+{
+  Config::Set("/NodeList/*/ApplicationList/*/MaxPushSize", UintegerValue(8000));
+  Config::Connect("/NodeList/*/ApplicationList/*/RecordGenerated",
+                  MakeCallback(&PeerTracerFixture::CountEvent, this));
+
+  PeerTracer::InstallAll(TEST_TRACE.string(), Seconds(1));
+
+  Simulator::Stop(Seconds(10));
+  Simulator::Run();
+
+  PeerTracer::Destroy(); // to force log to be written
+
+  // NOTIFs carry every record, so records are only fetched when a NOTIF is lost
+  auto samples = ReadSamples();
+  BOOST_CHECK_GT(samples["Pushed"], 0);
+  BOOST_CHECK_GT(samples["Pushed"], samples["Fetched"]);
+  BOOST_CHECK_LE(samples["Pushed"] + samples["Fetched"], 2 * nEvents["RecordGenerated"]);
+}
+
+BOOST_AUTO_TEST_CASE(NoSampling)
+{
+  PeerTracer::InstallAll(TEST_TRACE.string(), Seconds(1), 0.0);
+
+  Simulator::Stop(Seconds(10));
+  Simulator::Run();
+
+  PeerTracer::Destroy(); // to force log to be written
+
+  BOOST_CHECK(ReadSamples().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
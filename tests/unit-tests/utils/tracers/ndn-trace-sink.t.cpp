@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/tracers/ndn-trace-sink.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+const boost::filesystem::path TEST_TRACE = boost::filesystem::path(TEST_CONFIG_PATH) / "sink.txt";
+
+static void
+writeLine(std::ostream& os, int i)
+{
+  os << i << "\n";
+}
+
+BOOST_AUTO_TEST_SUITE(UtilsTracersNdnTraceSink)
+
+BOOST_AUTO_TEST_CASE(Synchronous)
+{
+  auto os = make_shared<std::ostringstream>();
+  TraceSink sink(os);
+  BOOST_CHECK(!sink.IsAsync());
+
+  sink.Write(std::bind(&writeLine, std::placeholders::_1, 1));
+  BOOST_CHECK_EQUAL(os->str(), "1\n");
+}
+
+BOOST_AUTO_TEST_CASE(AsynchronousOrder)
+{
+  auto os = make_shared<std::ostringstream>();
+  std::ostringstream expected;
+  {
+    // small ring, so that the simulation thread has to wait for the writer
+    TraceSink sink(os, 8);
+    BOOST_CHECK(sink.IsAsync());
+
+    for (int i = 0; i < 10000; ++i) {
+      sink.Write(std::bind(&writeLine, std::placeholders::_1, i));
+      writeLine(expected, i);
+
+      if (i == 5000) {
+        sink.Flush();
+        BOOST_CHECK_EQUAL(os->str().size(), expected.str().size());
+      }
+    }
+    sink.WriteText("end\n");
+    expected << "end\n";
+  } // the destructor runs the remaining writers
+
+  BOOST_CHECK_EQUAL(os->str(), expected.str());
+}
+
+BOOST_AUTO_TEST_CASE(FlushOnSimulatorDestroy)
+{
+  auto os = make_shared<std::ostringstream>();
+  TraceSink sink(os, 16);
+
+  sink.WriteText("Time\tNode\n");
+  Simulator::Destroy();
+  BOOST_CHECK_EQUAL(os->str(), "Time\tNode\n");
+}
+
+BOOST_AUTO_TEST_CASE(Open)
+{
+  boost::filesystem::create_directories(TEST_CONFIG_PATH);
+
+  shared_ptr<TraceSink> sink = TraceSink::Open("-");
+  BOOST_REQUIRE(sink != nullptr);
+  BOOST_CHECK(!sink->IsAsync());
+
+  sink = TraceSink::Open(TEST_TRACE.string());
+  BOOST_REQUIRE(sink != nullptr);
+  BOOST_CHECK(sink->IsAsync());
+  sink->WriteText("line\n");
+  sink.reset(); // closes the file
+
+  std::ifstream file(TEST_TRACE.string());
+  std::string line;
+  BOOST_CHECK(std::getline(file, line));
+  BOOST_CHECK_EQUAL(line, "line");
+  file.close();
+  boost::filesystem::remove(TEST_TRACE);
+
+  BOOST_CHECK(TraceSink::Open((TEST_TRACE / "no-such-dir" / "sink.txt").string()) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-trace-to-text.cpp
+
+#include "ns3/ndnSIM/utils/tracers/ndn-binary-trace.hpp"
+
+#include <fstream>
+#include <iostream>
+
+/**
+ * Converts a binary trace (written by a tracer installed with a file name ending in .bin)
+ * to the text table the tracer writes otherwise, e.g., for the R scripts in results/:
+ *
+ *     ./waf --run "ndn-trace-to-text rate-trace.bin rate-trace.txt"
+ *
+ * The text is written to the standard output if no output file is given.
+ */
+int
+main(int argc, char* argv[])
+{
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <binary-trace> [text-trace]" << std::endl;
+    return 2;
+  }
+
+  std::ifstream input(argv[1], std::ios_base::in | std::ios_base::binary);
+  if (!input.is_open()) {
+    std::cerr << "ERROR: cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::ofstream output;
+  if (argc == 3) {
+    output.open(argv[2], std::ios_base::out | std::ios_base::trunc);
+    if (!output.is_open()) {
+      std::cerr << "ERROR: cannot open " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+
+  try {
+    ns3::ndn::BinaryTraceReader reader(input);
+    reader.PrintText(argc == 3 ? output : std::cout);
+  }
+  catch (const ns3::ndn::BinaryTraceReader::Error& e) {
+    std::cerr << "ERROR: " << argv[1] << ": " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -150,6 +150,12 @@ AnnotatedTopologyReader::GetLinks() const
   return m_linksList;
 }
 
+void
+AnnotatedTopologyReader::SetSystemIds(const std::map<std::string, uint32_t>& systemIds)
+{
+  m_systemIds = systemIds;
+}
+
 NodeContainer
 AnnotatedTopologyReader::Read(void)
 {
@@ -191,6 +197,10 @@ AnnotatedTopologyReader::Read(void)
     if (name.empty())
       continue;
 
+    auto assigned = m_systemIds.find(name);
+    if (assigned != m_systemIds.end())
+      systemId = assigned->second;
+
     Ptr<Node> node;
 
     if (abs(latitude) > 0.001 && abs(latitude) > 0.001)
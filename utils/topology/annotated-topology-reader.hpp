@@ -56,6 +56,14 @@ public:
   virtual NodeContainer
   Read();
 
+  /**
+   * \brief Override system IDs of the topology file, e.g., with ndn::PartitionHelper::GetSystemIds()
+   *
+   * Nodes missing from the map keep the system ID of the file.  Must be called before Read().
+   */
+  void
+  SetSystemIds(const std::map<std::string, uint32_t>& systemIds);
+
   /**
    * \brief Get nodes read by the reader
    */
@@ -147,6 +155,7 @@ private:
   double m_scale;
 
   uint32_t m_requiredPartitions;
+  std::map<std::string, uint32_t> m_systemIds;
 };
 }
 
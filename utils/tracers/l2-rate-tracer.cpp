@@ -29,13 +29,13 @@
 #include "ns3/log.h"
 
 #include <boost/lexical_cast.hpp>
-#include <fstream>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE("L2RateTracer");
 
 namespace ns3 {
 
-static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<L2RateTracer>>>>
+static std::list<std::tuple<std::shared_ptr<ndn::TraceSink>, std::list<Ptr<L2RateTracer>>>>
   g_tracers;
 
 void
@@ -48,20 +48,9 @@ void
 L2RateTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Seconds (0.5)*/)
 {
   std::list<Ptr<L2RateTracer>> tracers;
-  std::shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    std::shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = std::shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  std::shared_ptr<ndn::TraceSink> outputStream = ndn::TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
@@ -74,16 +63,23 @@ L2RateTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Seco
 
   if (tracers.size() > 0) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
 }
 
 L2RateTracer::L2RateTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node)
+  : L2RateTracer(std::make_shared<ndn::TraceSink>(os), node)
+{
+}
+
+L2RateTracer::L2RateTracer(std::shared_ptr<ndn::TraceSink> sink, Ptr<Node> node)
   : L2Tracer(node)
-  , m_os(os)
+  , m_sink(sink)
 {
   SetAveragingPeriod(Seconds(1.0));
 }
@@ -104,7 +100,9 @@ L2RateTracer::SetAveragingPeriod(const Time& period)
 void
 L2RateTracer::PeriodicPrinter()
 {
-  Print(*m_os);
+  UpdateAverages();
+  m_sink->Write(std::bind(&L2RateTracer::PrintStats, std::placeholders::_1, Simulator::Now(),
+                          m_node, m_stats));
   Reset();
 
   m_printEvent = Simulator::Schedule(m_period, &L2RateTracer::PeriodicPrinter, this);
@@ -141,24 +139,38 @@ L2RateTracer::Reset()
 
 const double alpha = 0.8;
 
-#define STATS(INDEX) std::get<INDEX>(m_stats)
+#define STATS(INDEX) std::get<INDEX>(stats)
 #define RATE(INDEX, fieldName) STATS(INDEX).fieldName / m_period.ToDouble(Time::S)
 
-#define PRINTER(printName, fieldName, interface)                                                   \
+#define AVERAGE(fieldName)                                                                         \
   STATS(2).fieldName =                                                                             \
     /*new value*/ alpha * RATE(0, fieldName) + /*old value*/ (1 - alpha) * STATS(2).fieldName;     \
   STATS(3).fieldName = /*new value*/ alpha * RATE(1, fieldName) / 1024.0                           \
-                       + /*old value*/ (1 - alpha) * STATS(3).fieldName;                           \
-                                                                                                   \
-  os << time.ToDouble(Time::S) << "\t" << m_node << "\t" << interface << "\t" << printName << "\t" \
+                       + /*old value*/ (1 - alpha) * STATS(3).fieldName;
+
+#define PRINTER(printName, fieldName, interface)                                                   \
+  os << time.ToDouble(Time::S) << "\t" << node << "\t" << interface << "\t" << printName << "\t"   \
      << STATS(2).fieldName << "\t" << STATS(3).fieldName << "\t" << STATS(0).fieldName << "\t"     \
      << STATS(1).fieldName / 1024.0 << "\n";
 
+void
+L2RateTracer::UpdateAverages() const
+{
+  auto& stats = m_stats;
+  AVERAGE(m_drop);
+}
+
 void
 L2RateTracer::Print(std::ostream& os) const
 {
-  Time time = Simulator::Now();
+  UpdateAverages();
+  PrintStats(os, Simulator::Now(), m_node, m_stats);
+}
 
+void
+L2RateTracer::PrintStats(std::ostream& os, Time time, const std::string& node,
+                         const StatsTuple& stats)
+{
   PRINTER("Drop", m_drop, "combined");
 }
 
@@ -21,6 +21,7 @@
 #define L2_RATE_TRACER_H
 
 #include "l2-tracer.hpp"
+#include "ndn-trace-sink.hpp"
 
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
@@ -42,6 +43,11 @@ public:
    * @brief Network layer tracer constructor
    */
   L2RateTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node);
+
+  /**
+   * @brief Network layer tracer constructor writing to a (possibly asynchronous) sink
+   */
+  L2RateTracer(std::shared_ptr<ndn::TraceSink> sink, Ptr<Node> node);
   virtual ~L2RateTracer();
 
   /**
@@ -82,18 +88,26 @@ public:
   Drop(Ptr<const Packet>);
 
 private:
+  typedef std::tuple<Stats, Stats, Stats, Stats> StatsTuple;
+
   void
   PeriodicPrinter();
 
+  void
+  UpdateAverages() const;
+
+  static void
+  PrintStats(std::ostream& os, Time time, const std::string& node, const StatsTuple& stats);
+
   void
   Reset();
 
 private:
-  std::shared_ptr<std::ostream> m_os;
+  std::shared_ptr<ndn::TraceSink> m_sink;
   Time m_period;
   EventId m_printEvent;
 
-  mutable std::tuple<Stats, Stats, Stats, Stats> m_stats;
+  mutable StatsTuple m_stats;
 };
 
 } // namespace ns3
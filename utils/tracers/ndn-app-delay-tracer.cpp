@@ -32,14 +32,14 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 
-#include <fstream>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE("ndn.AppDelayTracer");
 
 namespace ns3 {
 namespace ndn {
 
-static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<AppDelayTracer>>>>
+static std::list<std::tuple<shared_ptr<TraceSink>, std::list<Ptr<AppDelayTracer>>>>
   g_tracers;
 
 void
@@ -55,20 +55,9 @@ AppDelayTracer::InstallAll(const std::string& file)
   using namespace std;
 
   std::list<Ptr<AppDelayTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
@@ -76,10 +65,12 @@ AppDelayTracer::InstallAll(const std::string& file)
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -92,20 +83,9 @@ AppDelayTracer::Install(const NodeContainer& nodes, const std::string& file)
   using namespace std;
 
   std::list<Ptr<AppDelayTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
@@ -113,10 +93,12 @@ AppDelayTracer::Install(const NodeContainer& nodes, const std::string& file)
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -129,29 +111,20 @@ AppDelayTracer::Install(Ptr<Node> node, const std::string& file)
   using namespace std;
 
   std::list<Ptr<AppDelayTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   Ptr<AppDelayTracer> trace = Install(node, outputStream);
   tracers.push_back(trace);
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -159,6 +132,12 @@ AppDelayTracer::Install(Ptr<Node> node, const std::string& file)
 
 Ptr<AppDelayTracer>
 AppDelayTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream)
+{
+  return Install(node, make_shared<TraceSink>(outputStream));
+}
+
+Ptr<AppDelayTracer>
+AppDelayTracer::Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream)
 {
   NS_LOG_DEBUG("Node: " << node->GetId());
 
@@ -172,8 +151,18 @@ AppDelayTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream)
 //////////////////////////////////////////////////////////////////////////////
 
 AppDelayTracer::AppDelayTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+  : AppDelayTracer(make_shared<TraceSink>(os), node)
+{
+}
+
+AppDelayTracer::AppDelayTracer(shared_ptr<std::ostream> os, const std::string& node)
+  : AppDelayTracer(make_shared<TraceSink>(os), node)
+{
+}
+
+AppDelayTracer::AppDelayTracer(shared_ptr<TraceSink> sink, Ptr<Node> node)
   : m_nodePtr(node)
-  , m_os(os)
+  , m_sink(sink)
 {
   m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
 
@@ -183,13 +172,16 @@ AppDelayTracer::AppDelayTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
   if (!name.empty()) {
     m_node = name;
   }
+
+  CreateEncoder();
 }
 
-AppDelayTracer::AppDelayTracer(shared_ptr<std::ostream> os, const std::string& node)
+AppDelayTracer::AppDelayTracer(shared_ptr<TraceSink> sink, const std::string& node)
   : m_node(node)
-  , m_os(os)
+  , m_sink(sink)
 {
   Connect();
+  CreateEncoder();
 }
 
 AppDelayTracer::~AppDelayTracer(){};
@@ -206,6 +198,27 @@ AppDelayTracer::Connect()
                                 MakeCallback(&AppDelayTracer::FirstInterestDataDelay, this));
 }
 
+void
+AppDelayTracer::CreateEncoder()
+{
+  if (!m_sink->IsBinary()) {
+    return;
+  }
+
+  std::ostringstream header;
+  PrintHeader(header);
+  m_encoder = m_sink->GetBinaryEncoder({"AppDelayTracer", header.str(),
+                                        {{BinaryTraceSchema::DOUBLE, "Time"},
+                                         {BinaryTraceSchema::STRING, "Node"},
+                                         {BinaryTraceSchema::INT, "AppId"},
+                                         {BinaryTraceSchema::INT, "SeqNo"},
+                                         {BinaryTraceSchema::STRING, "Type"},
+                                         {BinaryTraceSchema::DOUBLE, "DelayS"},
+                                         {BinaryTraceSchema::DOUBLE, "DelayUS"},
+                                         {BinaryTraceSchema::INT, "RetxCount"},
+                                         {BinaryTraceSchema::INT, "HopCount"}}});
+}
+
 void
 AppDelayTracer::PrintHeader(std::ostream& os) const
 {
@@ -234,22 +247,42 @@ void
 AppDelayTracer::LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay,
                                                    int32_t hopCount)
 {
-  *m_os << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t" << app->GetId() << "\t"
-        << seqno << "\t"
-        << "LastDelay"
-        << "\t" << delay.ToDouble(Time::S) << "\t" << delay.ToDouble(Time::US) << "\t" << 1 << "\t"
-        << hopCount << "\n";
+  m_sink->Write(std::bind(&AppDelayTracer::PrintDelay, std::placeholders::_1, m_encoder,
+                          Simulator::Now(), m_node, app->GetId(), seqno, "LastDelay", delay, 1,
+                          hopCount));
 }
 
 void
 AppDelayTracer::FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount,
                                        int32_t hopCount)
 {
-  *m_os << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t" << app->GetId() << "\t"
-        << seqno << "\t"
-        << "FullDelay"
-        << "\t" << delay.ToDouble(Time::S) << "\t" << delay.ToDouble(Time::US) << "\t" << retxCount
-        << "\t" << hopCount << "\n";
+  m_sink->Write(std::bind(&AppDelayTracer::PrintDelay, std::placeholders::_1, m_encoder,
+                          Simulator::Now(), m_node, app->GetId(), seqno, "FullDelay", delay,
+                          retxCount, hopCount));
+}
+
+void
+AppDelayTracer::PrintDelay(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder,
+                           Time time, const std::string& node, uint32_t appId, uint32_t seqno,
+                           const char* type, Time delay, uint32_t retxCount, int32_t hopCount)
+{
+  if (encoder != nullptr) {
+    encoder->AddDouble(time.ToDouble(Time::S))
+      .AddString(node)
+      .AddInt(appId)
+      .AddInt(seqno)
+      .AddString(type)
+      .AddDouble(delay.ToDouble(Time::S))
+      .AddDouble(delay.ToDouble(Time::US))
+      .AddInt(retxCount)
+      .AddInt(hopCount)
+      .EndRow(os);
+    return;
+  }
+
+  os << time.ToDouble(Time::S) << "\t" << node << "\t" << appId << "\t" << seqno << "\t" << type
+     << "\t" << delay.ToDouble(Time::S) << "\t" << delay.ToDouble(Time::US) << "\t" << retxCount
+     << "\t" << hopCount << "\n";
 }
 
 } // namespace ndn
@@ -22,6 +22,8 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
+#include "ndn-trace-sink.hpp"
+
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include <ns3/nstime.h>
@@ -49,7 +51,8 @@ public:
   /**
    * @brief Helper method to install tracers on all simulation nodes
    *
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    *
    */
   static void
@@ -59,7 +62,8 @@ public:
    * @brief Helper method to install tracers on the selected simulation nodes
    *
    * @param nodes Nodes on which to install tracer
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    *
    */
   static void
@@ -69,7 +73,8 @@ public:
    * @brief Helper method to install tracers on a specific simulation node
    *
    * @param nodes Nodes on which to install tracer
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    * @param averagingPeriod How often data will be written into the trace file (default, every half
    *        second)
    */
@@ -91,6 +96,15 @@ public:
   static Ptr<AppDelayTracer>
   Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream);
 
+  /**
+   * @brief Helper method to install tracers on a specific simulation node
+   *
+   * Several tracers may share the sink; records are formatted on the sink's writer thread
+   * if the sink is asynchronous.
+   */
+  static Ptr<AppDelayTracer>
+  Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream);
+
   /**
    * @brief Explicit request to remove all statically created tracers
    *
@@ -114,6 +128,20 @@ public:
    */
   AppDelayTracer(shared_ptr<std::ostream> os, const std::string& node);
 
+  /**
+   * @brief Trace constructor that attaches to all applications on the node using node's pointer
+   * @param sink  sink to which trace records are written
+   * @param node  pointer to the node
+   */
+  AppDelayTracer(shared_ptr<TraceSink> sink, Ptr<Node> node);
+
+  /**
+   * @brief Trace constructor that attaches to all applications on the node using node's name
+   * @param sink      sink to which trace records are written
+   * @param nodeName  name of the node registered using Names::Add
+   */
+  AppDelayTracer(shared_ptr<TraceSink> sink, const std::string& node);
+
   /**
    * @brief Destructor
    */
@@ -138,11 +166,21 @@ private:
   FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t rextCount,
                          int32_t hopCount);
 
+  void
+  CreateEncoder();
+
+  // writes text, or a binary row if encoder is not null
+  static void
+  PrintDelay(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder, Time time,
+             const std::string& node, uint32_t appId, uint32_t seqno, const char* type, Time delay,
+             uint32_t retxCount, int32_t hopCount);
+
 private:
   std::string m_node;
   Ptr<Node> m_nodePtr;
 
-  shared_ptr<std::ostream> m_os;
+  shared_ptr<TraceSink> m_sink;
+  shared_ptr<BinaryTraceEncoder> m_encoder;
 };
 
 } // namespace ndn
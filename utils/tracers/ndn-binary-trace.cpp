@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-binary-trace.hpp"
+
+#include "ns3/assert.h"
+
+#include <cstring>
+
+namespace ns3 {
+namespace ndn {
+
+static const char MAGIC[] = {'N', 'D', 'N', 'T', 'R', 'A', 'C', 'E'};
+
+static const char STRING_RECORD = 'S';
+static const char ROW_RECORD = 'R';
+
+static void
+appendUint32(std::string& buffer, uint32_t value)
+{
+  for (int i = 0; i < 4; ++i) {
+    buffer.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+static void
+appendUint64(std::string& buffer, uint64_t value)
+{
+  for (int i = 0; i < 8; ++i) {
+    buffer.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+static void
+appendString(std::string& buffer, const std::string& value)
+{
+  appendUint32(buffer, value.size());
+  buffer.append(value);
+}
+
+BinaryTraceEncoder::BinaryTraceEncoder(BinaryTraceSchema schema)
+  : m_schema(std::move(schema))
+  , m_nColumns(0)
+{
+  m_row.push_back(ROW_RECORD);
+}
+
+void
+BinaryTraceEncoder::WriteSchema(std::ostream& os) const
+{
+  std::string buffer(MAGIC, sizeof(MAGIC));
+  appendUint32(buffer, VERSION);
+  appendString(buffer, m_schema.table);
+  appendString(buffer, m_schema.header);
+  appendUint32(buffer, m_schema.columns.size());
+  for (const auto& column : m_schema.columns) {
+    buffer.push_back(static_cast<char>(column.type));
+    appendString(buffer, column.name);
+  }
+  os.write(buffer.data(), buffer.size());
+}
+
+BinaryTraceEncoder&
+BinaryTraceEncoder::AddDouble(double value)
+{
+  NS_ASSERT(m_nColumns < m_schema.columns.size()
+            && m_schema.columns[m_nColumns].type == BinaryTraceSchema::DOUBLE);
+
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  appendUint64(m_row, bits);
+  ++m_nColumns;
+  return *this;
+}
+
+BinaryTraceEncoder&
+BinaryTraceEncoder::AddInt(int64_t value)
+{
+  NS_ASSERT(m_nColumns < m_schema.columns.size()
+            && m_schema.columns[m_nColumns].type == BinaryTraceSchema::INT);
+
+  appendUint64(m_row, static_cast<uint64_t>(value));
+  ++m_nColumns;
+  return *this;
+}
+
+BinaryTraceEncoder&
+BinaryTraceEncoder::AddString(const std::string& value)
+{
+  NS_ASSERT(m_nColumns < m_schema.columns.size()
+            && m_schema.columns[m_nColumns].type == BinaryTraceSchema::STRING);
+
+  auto inserted = m_strings.emplace(value, m_strings.size());
+  if (inserted.second) {
+    m_definitions.push_back(STRING_RECORD);
+    appendUint32(m_definitions, inserted.first->second);
+    appendString(m_definitions, value);
+  }
+
+  appendUint32(m_row, inserted.first->second);
+  ++m_nColumns;
+  return *this;
+}
+
+void
+BinaryTraceEncoder::EndRow(std::ostream& os)
+{
+  NS_ASSERT(m_nColumns == m_schema.columns.size());
+
+  if (!m_definitions.empty()) {
+    os.write(m_definitions.data(), m_definitions.size());
+    m_definitions.clear();
+  }
+  os.write(m_row.data(), m_row.size());
+
+  m_row.resize(1);
+  m_nColumns = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+static void
+readBytes(std::istream& is, char* buffer, size_t size)
+{
+  if (!is.read(buffer, size)) {
+    throw BinaryTraceReader::Error("Binary trace is truncated");
+  }
+}
+
+static uint32_t
+readUint32(std::istream& is)
+{
+  unsigned char buffer[4];
+  readBytes(is, reinterpret_cast<char*>(buffer), sizeof(buffer));
+
+  uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    value |= static_cast<uint32_t>(buffer[i]) << (8 * i);
+  }
+  return value;
+}
+
+static uint64_t
+readUint64(std::istream& is)
+{
+  unsigned char buffer[8];
+  readBytes(is, reinterpret_cast<char*>(buffer), sizeof(buffer));
+
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+  }
+  return value;
+}
+
+static std::string
+readString(std::istream& is)
+{
+  std::string value(readUint32(is), '\0');
+  if (!value.empty()) {
+    readBytes(is, &value[0], value.size());
+  }
+  return value;
+}
+
+BinaryTraceReader::BinaryTraceReader(std::istream& is)
+  : m_is(is)
+{
+  char magic[sizeof(MAGIC)];
+  if (!m_is.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw Error("Not a binary trace");
+  }
+
+  uint32_t version = readUint32(m_is);
+  if (version != BinaryTraceEncoder::VERSION) {
+    throw Error("Unsupported binary trace version " + std::to_string(version));
+  }
+
+  m_schema.table = readString(m_is);
+  m_schema.header = readString(m_is);
+
+  uint32_t nColumns = readUint32(m_is);
+  for (uint32_t i = 0; i < nColumns; ++i) {
+    char type;
+    readBytes(m_is, &type, 1);
+    if (type != BinaryTraceSchema::DOUBLE && type != BinaryTraceSchema::INT
+        && type != BinaryTraceSchema::STRING) {
+      throw Error("Unknown column type " + std::to_string(type));
+    }
+    auto columnType = static_cast<BinaryTraceSchema::ColumnType>(type);
+    m_schema.columns.push_back({columnType, readString(m_is)});
+  }
+
+  m_values.resize(nColumns);
+}
+
+bool
+BinaryTraceReader::ReadRow()
+{
+  while (true) {
+    char tag;
+    if (!m_is.get(tag)) {
+      return false;
+    }
+
+    if (tag == STRING_RECORD) {
+      uint32_t id = readUint32(m_is);
+      if (id != m_strings.size()) {
+        throw Error("String " + std::to_string(id) + " is defined out of order");
+      }
+      m_strings.push_back(readString(m_is));
+    }
+    else if (tag == ROW_RECORD) {
+      for (size_t i = 0; i < m_values.size(); ++i) {
+        if (m_schema.columns[i].type == BinaryTraceSchema::STRING) {
+          m_values[i] = readUint32(m_is);
+          if (m_values[i] >= m_strings.size()) {
+            throw Error("Undefined string " + std::to_string(m_values[i]));
+          }
+        }
+        else {
+          m_values[i] = readUint64(m_is);
+        }
+      }
+      return true;
+    }
+    else {
+      throw Error("Unknown record type " + std::to_string(tag));
+    }
+  }
+}
+
+double
+BinaryTraceReader::GetDouble(size_t column) const
+{
+  NS_ASSERT(m_schema.columns[column].type == BinaryTraceSchema::DOUBLE);
+
+  double value;
+  std::memcpy(&value, &m_values[column], sizeof(value));
+  return value;
+}
+
+int64_t
+BinaryTraceReader::GetInt(size_t column) const
+{
+  NS_ASSERT(m_schema.columns[column].type == BinaryTraceSchema::INT);
+  return static_cast<int64_t>(m_values[column]);
+}
+
+const std::string&
+BinaryTraceReader::GetString(size_t column) const
+{
+  NS_ASSERT(m_schema.columns[column].type == BinaryTraceSchema::STRING);
+  return m_strings[m_values[column]];
+}
+
+void
+BinaryTraceReader::PrintText(std::ostream& os)
+{
+  os << m_schema.header << "\n";
+
+  while (ReadRow()) {
+    for (size_t i = 0; i < m_values.size(); ++i) {
+      if (i > 0) {
+        os << "\t";
+      }
+
+      switch (m_schema.columns[i].type) {
+      case BinaryTraceSchema::DOUBLE:
+        os << GetDouble(i);
+        break;
+      case BinaryTraceSchema::INT:
+        os << GetInt(i);
+        break;
+      case BinaryTraceSchema::STRING:
+        os << GetString(i);
+        break;
+      }
+    }
+    os << "\n";
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
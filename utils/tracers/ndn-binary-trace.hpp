@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_BINARY_TRACE_H
+#define NDN_BINARY_TRACE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <istream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Schema of a binary trace
+ *
+ * The binary trace format stores the rows of a tracer's text table in fixed-width records:
+ *
+ *   Trace    ::= "NDNTRACE" uint32(version) Schema Record*
+ *   Schema   ::= String(table) String(text header) uint32(count) (uint8(type) String(name))*
+ *   Record   ::= 'S' uint32(id) String      ; defines the next interned string
+ *              | 'R' Value*                 ; one value per column
+ *   Value    ::= double | int64 | uint32(string id)
+ *   String   ::= uint32(length) *BYTE
+ *
+ * Integers and doubles are little-endian.  Node names, face descriptions and record types are
+ * interned, and every string is defined once, before the first row that refers to it.
+ */
+struct BinaryTraceSchema {
+  enum ColumnType : uint8_t {
+    DOUBLE = 0,
+    INT = 1,
+    STRING = 2
+  };
+
+  struct Column {
+    ColumnType type;
+    std::string name;
+  };
+
+  std::string table;
+  // header line of the text format, so that the text table can be reproduced exactly
+  std::string header;
+  std::vector<Column> columns;
+};
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Encoder of binary trace rows
+ *
+ * Rows are built column by column, in the schema order, and written by EndRow.  The encoder
+ * keeps the string table, so all rows of a trace must be encoded by one encoder, in order.
+ */
+class BinaryTraceEncoder : boost::noncopyable {
+public:
+  static const uint32_t VERSION = 1;
+
+  explicit
+  BinaryTraceEncoder(BinaryTraceSchema schema);
+
+  const BinaryTraceSchema&
+  GetSchema() const
+  {
+    return m_schema;
+  }
+
+  void
+  WriteSchema(std::ostream& os) const;
+
+  BinaryTraceEncoder&
+  AddDouble(double value);
+
+  BinaryTraceEncoder&
+  AddInt(int64_t value);
+
+  BinaryTraceEncoder&
+  AddString(const std::string& value);
+
+  /**
+   * @brief Write the new strings and the row, and start the next row
+   */
+  void
+  EndRow(std::ostream& os);
+
+private:
+  BinaryTraceSchema m_schema;
+  std::unordered_map<std::string, uint32_t> m_strings;
+
+  std::string m_definitions;
+  std::string m_row;
+  size_t m_nColumns;
+};
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Reader of binary traces
+ */
+class BinaryTraceReader : boost::noncopyable {
+public:
+  class Error : public std::runtime_error {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @brief Read the schema of the trace
+   * @throw Error the stream is not a binary trace
+   */
+  explicit
+  BinaryTraceReader(std::istream& is);
+
+  const BinaryTraceSchema&
+  GetSchema() const
+  {
+    return m_schema;
+  }
+
+  /**
+   * @brief Read the next row
+   * @return false at the end of the trace
+   * @throw Error the trace is truncated or corrupted
+   */
+  bool
+  ReadRow();
+
+  double
+  GetDouble(size_t column) const;
+
+  int64_t
+  GetInt(size_t column) const;
+
+  const std::string&
+  GetString(size_t column) const;
+
+  /**
+   * @brief Write the rest of the trace in the text format of the tracer that wrote it
+   */
+  void
+  PrintText(std::ostream& os);
+
+private:
+  std::istream& m_is;
+  BinaryTraceSchema m_schema;
+  std::vector<std::string> m_strings;
+
+  std::vector<uint64_t> m_values;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_BINARY_TRACE_H
@@ -32,14 +32,14 @@
 
 #include <boost/lexical_cast.hpp>
 
-#include <fstream>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE("ndn.CsTracer");
 
 namespace ns3 {
 namespace ndn {
 
-static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<CsTracer>>>> g_tracers;
+static std::list<std::tuple<shared_ptr<TraceSink>, std::list<Ptr<CsTracer>>>> g_tracers;
 
 void
 CsTracer::Destroy()
@@ -54,20 +54,9 @@ CsTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Seconds
   using namespace std;
 
   std::list<Ptr<CsTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
@@ -75,10 +64,12 @@ CsTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Seconds
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -92,20 +83,9 @@ CsTracer::Install(const NodeContainer& nodes, const std::string& file,
   using namespace std;
 
   std::list<Ptr<CsTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
@@ -113,10 +93,12 @@ CsTracer::Install(const NodeContainer& nodes, const std::string& file,
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -130,29 +112,20 @@ CsTracer::Install(Ptr<Node> node, const std::string& file,
   using namespace std;
 
   std::list<Ptr<CsTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   Ptr<CsTracer> trace = Install(node, outputStream, averagingPeriod);
   tracers.push_back(trace);
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -161,6 +134,13 @@ CsTracer::Install(Ptr<Node> node, const std::string& file,
 Ptr<CsTracer>
 CsTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
                   Time averagingPeriod /* = Seconds (0.5)*/)
+{
+  return Install(node, make_shared<TraceSink>(outputStream), averagingPeriod);
+}
+
+Ptr<CsTracer>
+CsTracer::Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream,
+                  Time averagingPeriod /* = Seconds (0.5)*/)
 {
   NS_LOG_DEBUG("Node: " << node->GetId());
 
@@ -175,8 +155,18 @@ CsTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
 //////////////////////////////////////////////////////////////////////////////
 
 CsTracer::CsTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+  : CsTracer(make_shared<TraceSink>(os), node)
+{
+}
+
+CsTracer::CsTracer(shared_ptr<std::ostream> os, const std::string& node)
+  : CsTracer(make_shared<TraceSink>(os), node)
+{
+}
+
+CsTracer::CsTracer(shared_ptr<TraceSink> sink, Ptr<Node> node)
   : m_nodePtr(node)
-  , m_os(os)
+  , m_sink(sink)
 {
   m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
 
@@ -186,13 +176,16 @@ CsTracer::CsTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
   if (!name.empty()) {
     m_node = name;
   }
+
+  CreateEncoder();
 }
 
-CsTracer::CsTracer(shared_ptr<std::ostream> os, const std::string& node)
+CsTracer::CsTracer(shared_ptr<TraceSink> sink, const std::string& node)
   : m_node(node)
-  , m_os(os)
+  , m_sink(sink)
 {
   Connect();
+  CreateEncoder();
 }
 
 CsTracer::~CsTracer(){};
@@ -207,6 +200,22 @@ CsTracer::Connect()
   Reset();
 }
 
+void
+CsTracer::CreateEncoder()
+{
+  if (!m_sink->IsBinary()) {
+    return;
+  }
+
+  std::ostringstream header;
+  PrintHeader(header);
+  m_encoder = m_sink->GetBinaryEncoder({"CsTracer", header.str(),
+                                        {{BinaryTraceSchema::DOUBLE, "Time"},
+                                         {BinaryTraceSchema::STRING, "Node"},
+                                         {BinaryTraceSchema::STRING, "Type"},
+                                         {BinaryTraceSchema::DOUBLE, "Packets"}}});
+}
+
 void
 CsTracer::SetAveragingPeriod(const Time& period)
 {
@@ -218,7 +227,8 @@ CsTracer::SetAveragingPeriod(const Time& period)
 void
 CsTracer::PeriodicPrinter()
 {
-  Print(*m_os);
+  m_sink->Write(std::bind(&CsTracer::PrintStats, std::placeholders::_1, m_encoder, Simulator::Now(),
+                          m_node, m_stats));
   Reset();
 
   m_printEvent = Simulator::Schedule(m_period, &CsTracer::PeriodicPrinter, this);
@@ -246,14 +256,28 @@ CsTracer::Reset()
 }
 
 #define PRINTER(printName, fieldName)                                                              \
-  os << time.ToDouble(Time::S) << "\t" << m_node << "\t" << printName << "\t" << m_stats.fieldName \
-     << "\n";
+  if (encoder != nullptr) {                                                                        \
+    encoder->AddDouble(time.ToDouble(Time::S))                                                     \
+      .AddString(node)                                                                             \
+      .AddString(printName)                                                                        \
+      .AddDouble(stats.fieldName)                                                                  \
+      .EndRow(os);                                                                                 \
+  }                                                                                                \
+  else {                                                                                           \
+    os << time.ToDouble(Time::S) << "\t" << node << "\t" << printName << "\t" << stats.fieldName   \
+       << "\n";                                                                                    \
+  }
 
 void
 CsTracer::Print(std::ostream& os) const
 {
-  Time time = Simulator::Now();
+  PrintStats(os, nullptr, Simulator::Now(), m_node, m_stats);
+}
 
+void
+CsTracer::PrintStats(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder, Time time,
+                     const std::string& node, const cs::Stats& stats)
+{
   PRINTER("CacheHits", m_cacheHits);
   PRINTER("CacheMisses", m_cacheMisses);
 }
@@ -22,6 +22,8 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
+#include "ndn-trace-sink.hpp"
+
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include <ns3/nstime.h>
@@ -64,7 +66,8 @@ public:
   /**
    * @brief Helper method to install tracers on all simulation nodes
    *
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    * @param averagingPeriod How often data will be written into the trace file (default, every half
    *second)
    *
@@ -80,7 +83,8 @@ public:
    * @brief Helper method to install tracers on the selected simulation nodes
    *
    * @param nodes Nodes on which to install tracer
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    * @param averagingPeriod How often data will be written into the trace file (default, every half
    *second)
    *
@@ -96,7 +100,8 @@ public:
    * @brief Helper method to install tracers on a specific simulation node
    *
    * @param nodes Nodes on which to install tracer
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    * @param averagingPeriod How often data will be written into the trace file (default, every half
    *second)
    *
@@ -124,6 +129,16 @@ public:
   Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
           Time averagingPeriod = Seconds(0.5));
 
+  /**
+   * @brief Helper method to install tracers on a specific simulation node
+   *
+   * Several tracers may share the sink; records are formatted on the sink's writer thread
+   * if the sink is asynchronous.
+   */
+  static Ptr<CsTracer>
+  Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream,
+          Time averagingPeriod = Seconds(0.5));
+
   /**
    * @brief Explicit request to remove all statically created tracers
    *
@@ -147,6 +162,20 @@ public:
    */
   CsTracer(shared_ptr<std::ostream> os, const std::string& node);
 
+  /**
+   * @brief Trace constructor that attaches to the node using node pointer
+   * @param sink  sink to which trace records are written
+   * @param node  pointer to the node
+   */
+  CsTracer(shared_ptr<TraceSink> sink, Ptr<Node> node);
+
+  /**
+   * @brief Trace constructor that attaches to the node using node name
+   * @param sink      sink to which trace records are written
+   * @param nodeName  name of the node registered using Names::Add
+   */
+  CsTracer(shared_ptr<TraceSink> sink, const std::string& node);
+
   /**
    * @brief Destructor
    */
@@ -179,6 +208,9 @@ private:
   CacheMisses(shared_ptr<const Interest>);
 
 private:
+  void
+  CreateEncoder();
+
   void
   SetAveragingPeriod(const Time& period);
 
@@ -188,11 +220,17 @@ private:
   void
   PeriodicPrinter();
 
+  // writes text, or a binary row if encoder is not null
+  static void
+  PrintStats(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder, Time time,
+             const std::string& node, const cs::Stats& stats);
+
 private:
   std::string m_node;
   Ptr<Node> m_nodePtr;
 
-  shared_ptr<std::ostream> m_os;
+  shared_ptr<TraceSink> m_sink;
+  shared_ptr<BinaryTraceEncoder> m_encoder;
 
   Time m_period;
   EventId m_printEvent;
@@ -29,7 +29,7 @@
 
 #include "daemon/table/pit-entry.hpp"
 
-#include <fstream>
+#include <sstream>
 #include <boost/lexical_cast.hpp>
 
 NS_LOG_COMPONENT_DEFINE("ndn.L3RateTracer");
@@ -37,7 +37,7 @@ NS_LOG_COMPONENT_DEFINE("ndn.L3RateTracer");
 namespace ns3 {
 namespace ndn {
 
-static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<L3RateTracer>>>>
+static std::list<std::tuple<shared_ptr<TraceSink>, std::list<Ptr<L3RateTracer>>>>
   g_tracers;
 
 void
@@ -50,20 +50,9 @@ void
 L3RateTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Seconds (0.5)*/)
 {
   std::list<Ptr<L3RateTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
@@ -71,10 +60,12 @@ L3RateTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Seco
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -88,20 +79,9 @@ L3RateTracer::Install(const NodeContainer& nodes, const std::string& file,
   using namespace std;
 
   std::list<Ptr<L3RateTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
@@ -109,10 +89,12 @@ L3RateTracer::Install(const NodeContainer& nodes, const std::string& file,
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -126,29 +108,20 @@ L3RateTracer::Install(Ptr<Node> node, const std::string& file,
   using namespace std;
 
   std::list<Ptr<L3RateTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
   }
 
   Ptr<L3RateTracer> trace = Install(node, outputStream, averagingPeriod);
   tracers.push_back(trace);
 
-  if (tracers.size() > 0) {
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
   }
 
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
@@ -157,6 +130,13 @@ L3RateTracer::Install(Ptr<Node> node, const std::string& file,
 Ptr<L3RateTracer>
 L3RateTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
                       Time averagingPeriod /* = Seconds (0.5)*/)
+{
+  return Install(node, make_shared<TraceSink>(outputStream), averagingPeriod);
+}
+
+Ptr<L3RateTracer>
+L3RateTracer::Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream,
+                      Time averagingPeriod /* = Seconds (0.5)*/)
 {
   NS_LOG_DEBUG("Node: " << node->GetId());
 
@@ -167,16 +147,28 @@ L3RateTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
 }
 
 L3RateTracer::L3RateTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+  : L3RateTracer(make_shared<TraceSink>(os), node)
+{
+}
+
+L3RateTracer::L3RateTracer(shared_ptr<std::ostream> os, const std::string& node)
+  : L3RateTracer(make_shared<TraceSink>(os), node)
+{
+}
+
+L3RateTracer::L3RateTracer(shared_ptr<TraceSink> sink, Ptr<Node> node)
   : L3Tracer(node)
-  , m_os(os)
+  , m_sink(sink)
 {
+  CreateEncoder();
   SetAveragingPeriod(Seconds(1.0));
 }
 
-L3RateTracer::L3RateTracer(shared_ptr<std::ostream> os, const std::string& node)
+L3RateTracer::L3RateTracer(shared_ptr<TraceSink> sink, const std::string& node)
   : L3Tracer(node)
-  , m_os(os)
+  , m_sink(sink)
 {
+  CreateEncoder();
   SetAveragingPeriod(Seconds(1.0));
 }
 
@@ -185,6 +177,27 @@ L3RateTracer::~L3RateTracer()
   m_printEvent.Cancel();
 }
 
+void
+L3RateTracer::CreateEncoder()
+{
+  if (!m_sink->IsBinary()) {
+    return;
+  }
+
+  std::ostringstream header;
+  PrintHeader(header);
+  m_encoder = m_sink->GetBinaryEncoder({"L3RateTracer", header.str(),
+                                        {{BinaryTraceSchema::DOUBLE, "Time"},
+                                         {BinaryTraceSchema::STRING, "Node"},
+                                         {BinaryTraceSchema::INT, "FaceId"},
+                                         {BinaryTraceSchema::STRING, "FaceDescr"},
+                                         {BinaryTraceSchema::STRING, "Type"},
+                                         {BinaryTraceSchema::DOUBLE, "Packets"},
+                                         {BinaryTraceSchema::DOUBLE, "Kilobytes"},
+                                         {BinaryTraceSchema::DOUBLE, "PacketRaw"},
+                                         {BinaryTraceSchema::DOUBLE, "KilobytesRaw"}}});
+}
+
 void
 L3RateTracer::SetAveragingPeriod(const Time& period)
 {
@@ -196,7 +209,10 @@ L3RateTracer::SetAveragingPeriod(const Time& period)
 void
 L3RateTracer::PeriodicPrinter()
 {
-  Print(*m_os);
+  // averages are updated here, while the snapshot is formatted by the sink
+  UpdateAverages();
+  m_sink->Write(std::bind(&L3RateTracer::PrintStats, std::placeholders::_1, m_encoder,
+                          Simulator::Now(), m_node, m_stats, m_faceInfos));
   Reset();
 
   m_printEvent = Simulator::Schedule(m_period, &L3RateTracer::PeriodicPrinter, this);
@@ -240,30 +256,77 @@ const double alpha = 0.8;
 #define STATS(INDEX) std::get<INDEX>(stats.second)
 #define RATE(INDEX, fieldName) STATS(INDEX).fieldName / m_period.ToDouble(Time::S)
 
-#define PRINTER(printName, fieldName)                                                              \
+#define AVERAGE(fieldName)                                                                         \
   STATS(2).fieldName =                                                                             \
     /*new value*/ alpha * RATE(0, fieldName) + /*old value*/ (1 - alpha) * STATS(2).fieldName;     \
   STATS(3).fieldName = /*new value*/ alpha * RATE(1, fieldName) / 1024.0                           \
-                       + /*old value*/ (1 - alpha) * STATS(3).fieldName;                           \
-                                                                                                   \
-  os << time.ToDouble(Time::S) << "\t" << m_node << "\t";                                          \
-  if (stats.first != nfd::face::INVALID_FACEID) {                                                  \
-    os << stats.first << "\t";                                                                     \
-    NS_ASSERT(m_faceInfos.find(stats.first) != m_faceInfos.end());                                 \
-    os << m_faceInfos.find(stats.first)->second << "\t";                                           \
+                       + /*old value*/ (1 - alpha) * STATS(3).fieldName;
+
+#define PRINTER(printName, fieldName)                                                              \
+  if (encoder != nullptr) {                                                                        \
+    encoder->AddDouble(time.ToDouble(Time::S)).AddString(node);                                    \
+    if (stats.first != nfd::face::INVALID_FACEID) {                                                \
+      NS_ASSERT(faceInfos.find(stats.first) != faceInfos.end());                                   \
+      encoder->AddInt(stats.first).AddString(faceInfos.find(stats.first)->second);                 \
+    }                                                                                              \
+    else {                                                                                         \
+      encoder->AddInt(-1).AddString("all");                                                        \
+    }                                                                                              \
+    encoder->AddString(printName)                                                                  \
+      .AddDouble(STATS(2).fieldName)                                                               \
+      .AddDouble(STATS(3).fieldName)                                                               \
+      .AddDouble(STATS(0).fieldName)                                                               \
+      .AddDouble(STATS(1).fieldName / 1024.0)                                                      \
+      .EndRow(os);                                                                                 \
   }                                                                                                \
   else {                                                                                           \
-    os << "-1\tall\t";                                                                             \
-  }                                                                                                \
-  os << printName << "\t" << STATS(2).fieldName << "\t" << STATS(3).fieldName << "\t"              \
-     << STATS(0).fieldName << "\t" << STATS(1).fieldName / 1024.0 << "\n";
+    os << time.ToDouble(Time::S) << "\t" << node << "\t";                                          \
+    if (stats.first != nfd::face::INVALID_FACEID) {                                                \
+      os << stats.first << "\t";                                                                   \
+      NS_ASSERT(faceInfos.find(stats.first) != faceInfos.end());                                   \
+      os << faceInfos.find(stats.first)->second << "\t";                                           \
+    }                                                                                              \
+    else {                                                                                         \
+      os << "-1\tall\t";                                                                           \
+    }                                                                                              \
+    os << printName << "\t" << STATS(2).fieldName << "\t" << STATS(3).fieldName << "\t"            \
+       << STATS(0).fieldName << "\t" << STATS(1).fieldName / 1024.0 << "\n";                       \
+  }
+
+void
+L3RateTracer::UpdateAverages() const
+{
+  for (auto& stats : m_stats) {
+    AVERAGE(m_inInterests);
+    AVERAGE(m_outInterests);
+
+    AVERAGE(m_inData);
+    AVERAGE(m_outData);
+
+    AVERAGE(m_inNack);
+    AVERAGE(m_outNack);
+
+    AVERAGE(m_satisfiedInterests);
+    AVERAGE(m_timedOutInterests);
+
+    AVERAGE(m_outSatisfiedInterests);
+    AVERAGE(m_outTimedOutInterests);
+  }
+}
 
 void
 L3RateTracer::Print(std::ostream& os) const
 {
-  Time time = Simulator::Now();
+  UpdateAverages();
+  PrintStats(os, nullptr, Simulator::Now(), m_node, m_stats, m_faceInfos);
+}
 
-  for (auto& stats : m_stats) {
+void
+L3RateTracer::PrintStats(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder,
+                         Time time, const std::string& node, const StatsMap& allStats,
+                         const std::map<nfd::FaceId, std::string>& faceInfos)
+{
+  for (auto& stats : allStats) {
     if (stats.first == nfd::face::INVALID_FACEID)
       continue;
 
@@ -284,8 +347,8 @@ L3RateTracer::Print(std::ostream& os) const
   }
 
   {
-    auto i = m_stats.find(nfd::face::INVALID_FACEID);
-    if (i != m_stats.end()) {
+    auto i = allStats.find(nfd::face::INVALID_FACEID);
+    if (i != allStats.end()) {
       auto& stats = *i;
       PRINTER("SatisfiedInterests", m_satisfiedInterests);
       PRINTER("TimedOutInterests", m_timedOutInterests);
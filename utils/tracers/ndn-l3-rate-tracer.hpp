@@ -23,6 +23,7 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include "ndn-l3-tracer.hpp"
+#include "ndn-trace-sink.hpp"
 
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
@@ -44,7 +45,8 @@ public:
   /**
    * @brief Helper method to install tracers on all simulation nodes
    *
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    * @param averagingPeriod Defines averaging period for the rate calculation,
    *        as well as how often data will be written into the trace file (default, every half
    *second)
@@ -56,7 +58,8 @@ public:
    * @brief Helper method to install tracers on the selected simulation nodes
    *
    * @param nodes Nodes on which to install tracer
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    * @param averagingPeriod How often data will be written into the trace file (default, every half
    *second)
    */
@@ -67,7 +70,8 @@ public:
    * @brief Helper method to install tracers on a specific simulation node
    *
    * @param nodes Nodes on which to install tracer
-   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
    * @param averagingPeriod How often data will be written into the trace file (default, every half
    *second)
    */
@@ -97,6 +101,20 @@ public:
    */
   L3RateTracer(shared_ptr<std::ostream> os, const std::string& node);
 
+  /**
+   * @brief Trace constructor that attaches to the node using node pointer
+   * @param sink  sink to which trace records are written
+   * @param node  pointer to the node
+   */
+  L3RateTracer(shared_ptr<TraceSink> sink, Ptr<Node> node);
+
+  /**
+   * @brief Trace constructor that attaches to the node using node name
+   * @param sink      sink to which trace records are written
+   * @param nodeName  name of the node registered using Names::Add
+   */
+  L3RateTracer(shared_ptr<TraceSink> sink, const std::string& node);
+
   /**
    * @brief Destructor
    */
@@ -118,6 +136,16 @@ public:
   Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
           Time averagingPeriod = Seconds(0.5));
 
+  /**
+   * @brief Helper method to install tracers on a specific simulation node
+   *
+   * Several tracers may share the sink; records are formatted on the sink's writer thread
+   * if the sink is asynchronous.
+   */
+  static Ptr<L3RateTracer>
+  Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream,
+          Time averagingPeriod = Seconds(0.5));
+
   // from L3Tracer
   virtual void
   PrintHeader(std::ostream& os) const;
@@ -152,9 +180,23 @@ protected:
   TimedOutInterests(const nfd::pit::Entry&);
 
 private:
+  typedef std::map<nfd::FaceId, std::tuple<Stats, Stats, Stats, Stats>> StatsMap;
+
+  void
+  CreateEncoder();
+
   void
   SetAveragingPeriod(const Time& period);
 
+  void
+  UpdateAverages() const;
+
+  // writes text, or binary rows if encoder is not null
+  static void
+  PrintStats(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder, Time time,
+             const std::string& node, const StatsMap& stats,
+             const std::map<nfd::FaceId, std::string>& faceInfos);
+
   void
   PeriodicPrinter();
 
@@ -165,11 +207,12 @@ private:
   AddInfo(const Face& face);
 
 private:
-  shared_ptr<std::ostream> m_os;
+  shared_ptr<TraceSink> m_sink;
+  shared_ptr<BinaryTraceEncoder> m_encoder;
   Time m_period;
   EventId m_printEvent;
 
-  mutable std::map<nfd::FaceId, std::tuple<Stats, Stats, Stats, Stats>> m_stats;
+  mutable StatsMap m_stats;
   std::map<nfd::FaceId, std::string> m_faceInfos; // needed, because face may no longer exists at the time of stat printing
 };
 
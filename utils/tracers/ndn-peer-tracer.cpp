@@ -0,0 +1,458 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-peer-tracer.hpp"
+#include "ns3/node.h"
+#include "ns3/config.h"
+#include "ns3/names.h"
+#include "ns3/callback.h"
+
+#include "apps/ndn-app.hpp"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/log.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.PeerTracer");
+
+namespace ns3 {
+namespace ndn {
+
+static std::list<std::tuple<shared_ptr<TraceSink>, std::list<Ptr<PeerTracer>>>> g_tracers;
+
+static const char* const STAGE_NAMES[] = {"NotifReceived", "Fetched", "Pushed", "Pending",
+                                          "Propagation", "Confirmation"};
+
+/**
+ * Generation times of the sampled records, shared by the tracers of all nodes.  Open addressing
+ * over a flat array, so that tracing a record does not allocate.  Records are never forgotten,
+ * as any node may still admit or archive them, until PeerTracer::Destroy.
+ */
+class GenerationTable {
+public:
+  struct Entry {
+    RecordDigest digest;
+    Time time;
+    uint32_t node;
+    bool isUsed;
+  };
+
+  void
+  Insert(const RecordDigest& digest, Time time, uint32_t node)
+  {
+    if ((m_size + 1) * 2 > m_entries.size()) {
+      Grow();
+    }
+
+    Entry& entry = m_entries[Probe(m_entries, digest)];
+    if (!entry.isUsed) {
+      entry = {digest, time, node, true};
+      ++m_size;
+    }
+  }
+
+  const Entry*
+  Find(const RecordDigest& digest) const
+  {
+    if (m_entries.empty()) {
+      return nullptr;
+    }
+
+    const Entry& entry = m_entries[Probe(m_entries, digest)];
+    return entry.isUsed ? &entry : nullptr;
+  }
+
+  void
+  Clear()
+  {
+    std::vector<Entry>().swap(m_entries);
+    m_size = 0;
+  }
+
+private:
+  // index of the digest, or of the free entry where it belongs; the size is a power of two
+  static size_t
+  Probe(const std::vector<Entry>& entries, const RecordDigest& digest)
+  {
+    size_t mask = entries.size() - 1;
+    for (size_t i = RecordDigestHash()(digest) & mask;; i = (i + 1) & mask) {
+      if (!entries[i].isUsed || entries[i].digest == digest) {
+        return i;
+      }
+    }
+  }
+
+  void
+  Grow()
+  {
+    std::vector<Entry> entries(std::max<size_t>(m_entries.size() * 2, 1024));
+    for (const auto& entry : m_entries) {
+      if (entry.isUsed) {
+        entries[Probe(entries, entry.digest)] = entry;
+      }
+    }
+    m_entries.swap(entries);
+  }
+
+private:
+  std::vector<Entry> m_entries;
+  size_t m_size = 0;
+};
+
+static GenerationTable g_generated;
+
+void
+PeerTracer::Destroy()
+{
+  g_tracers.clear();
+  g_generated.Clear();
+}
+
+void
+PeerTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Seconds (1.0)*/,
+                       double samplingRate /* = 1.0*/)
+{
+  std::list<Ptr<PeerTracer>> tracers;
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
+  }
+
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    Ptr<PeerTracer> trace = Install(*node, outputStream, averagingPeriod, samplingRate);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
+  }
+
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+void
+PeerTracer::Install(const NodeContainer& nodes, const std::string& file,
+                    Time averagingPeriod /* = Seconds (1.0)*/, double samplingRate /* = 1.0*/)
+{
+  std::list<Ptr<PeerTracer>> tracers;
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    Ptr<PeerTracer> trace = Install(*node, outputStream, averagingPeriod, samplingRate);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
+  }
+
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+void
+PeerTracer::Install(Ptr<Node> node, const std::string& file,
+                    Time averagingPeriod /* = Seconds (1.0)*/, double samplingRate /* = 1.0*/)
+{
+  std::list<Ptr<PeerTracer>> tracers;
+  shared_ptr<TraceSink> outputStream = TraceSink::Open(file);
+  if (outputStream == nullptr) {
+    return;
+  }
+
+  Ptr<PeerTracer> trace = Install(node, outputStream, averagingPeriod, samplingRate);
+  tracers.push_back(trace);
+
+  if (tracers.size() > 0 && !outputStream->IsBinary()) {
+    std::ostringstream header;
+    tracers.front()->PrintHeader(header);
+    header << "\n";
+    outputStream->WriteText(header.str());
+  }
+
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+Ptr<PeerTracer>
+PeerTracer::Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream,
+                    Time averagingPeriod /* = Seconds (1.0)*/, double samplingRate /* = 1.0*/)
+{
+  NS_LOG_DEBUG("Node: " << node->GetId());
+
+  Ptr<PeerTracer> trace = Create<PeerTracer>(outputStream, node);
+  trace->SetSamplingRate(samplingRate);
+  trace->SetAveragingPeriod(averagingPeriod);
+
+  return trace;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+PeerTracer::PeerTracer(shared_ptr<TraceSink> sink, Ptr<Node> node)
+  : m_nodePtr(node)
+  , m_sink(sink)
+  , m_samplingRate(1.0)
+  , m_samplingThreshold(0)
+{
+  m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
+
+  Connect();
+
+  std::string name = Names::FindName(node);
+  if (!name.empty()) {
+    m_node = name;
+  }
+
+  CreateEncoder();
+}
+
+PeerTracer::~PeerTracer()
+{
+  m_printEvent.Cancel();
+}
+
+void
+PeerTracer::Connect()
+{
+  std::string apps = "/NodeList/" + m_node + "/ApplicationList/*/";
+
+  Config::ConnectWithoutContext(apps + "RecordGenerated",
+                                MakeCallback(&PeerTracer::RecordGenerated, this));
+  Config::ConnectWithoutContext(apps + "NotifReceived",
+                                MakeCallback(&PeerTracer::NotifReceived, this));
+  Config::ConnectWithoutContext(apps + "RecordFetched",
+                                MakeCallback(&PeerTracer::RecordFetched, this));
+  Config::ConnectWithoutContext(apps + "RecordPushed",
+                                MakeCallback(&PeerTracer::RecordPushed, this));
+  Config::ConnectWithoutContext(apps + "RecordPending",
+                                MakeCallback(&PeerTracer::RecordPending, this));
+  Config::ConnectWithoutContext(apps + "RecordAdmitted",
+                                MakeCallback(&PeerTracer::RecordAdmitted, this));
+  Config::ConnectWithoutContext(apps + "RecordArchived",
+                                MakeCallback(&PeerTracer::RecordArchived, this));
+}
+
+void
+PeerTracer::CreateEncoder()
+{
+  if (!m_sink->IsBinary()) {
+    return;
+  }
+
+  std::ostringstream header;
+  PrintHeader(header);
+  m_encoder = m_sink->GetBinaryEncoder({"PeerTracer", header.str(),
+                                        {{BinaryTraceSchema::DOUBLE, "Time"},
+                                         {BinaryTraceSchema::STRING, "Node"},
+                                         {BinaryTraceSchema::STRING, "Type"},
+                                         {BinaryTraceSchema::INT, "Samples"},
+                                         {BinaryTraceSchema::DOUBLE, "P50"},
+                                         {BinaryTraceSchema::DOUBLE, "P90"},
+                                         {BinaryTraceSchema::DOUBLE, "P99"},
+                                         {BinaryTraceSchema::DOUBLE, "Max"}}});
+}
+
+void
+PeerTracer::PrintHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "Type"
+     << "\t"
+     << "Samples"
+     << "\t"
+
+     << "P50"
+     << "\t"
+     << "P90"
+     << "\t"
+     << "P99"
+     << "\t"
+     << "Max"
+     << "";
+}
+
+void
+PeerTracer::SetAveragingPeriod(const Time& period)
+{
+  m_period = period;
+  m_printEvent.Cancel();
+  m_printEvent = Simulator::Schedule(m_period, &PeerTracer::PeriodicPrinter, this);
+}
+
+void
+PeerTracer::SetSamplingRate(double rate)
+{
+  m_samplingRate = rate;
+  if (rate < 1.0) {
+    // digests are uniformly distributed, so their first 8 bytes are a uniform 64-bit number
+    m_samplingThreshold = static_cast<uint64_t>(std::ldexp(std::max(rate, 0.0), 64));
+  }
+}
+
+bool
+PeerTracer::IsSampled(const RecordDigest& digest) const
+{
+  if (m_samplingRate >= 1.0) {
+    return true;
+  }
+
+  uint64_t hash;
+  std::memcpy(&hash, digest.data(), sizeof(hash));
+  return hash < m_samplingThreshold;
+}
+
+void
+PeerTracer::RecordGenerated(Ptr<App> app, const RecordDigest& digest, RecordId record)
+{
+  if (IsSampled(digest)) {
+    g_generated.Insert(digest, Simulator::Now(), m_nodePtr->GetId());
+  }
+}
+
+void
+PeerTracer::NotifReceived(Ptr<App> app, const RecordDigest& digest, RecordId record)
+{
+  if (record == INVALID_RECORD_ID) {
+    AddSample(NOTIF_RECEIVED, digest);
+  }
+}
+
+void
+PeerTracer::RecordFetched(Ptr<App> app, const RecordDigest& digest, RecordId record)
+{
+  AddSample(FETCHED, digest);
+}
+
+void
+PeerTracer::RecordPushed(Ptr<App> app, const RecordDigest& digest, RecordId record)
+{
+  AddSample(PUSHED, digest);
+}
+
+void
+PeerTracer::RecordPending(Ptr<App> app, const RecordDigest& digest, RecordId record)
+{
+  AddSample(PENDING, digest);
+}
+
+void
+PeerTracer::RecordAdmitted(Ptr<App> app, const RecordDigest& digest, RecordId record)
+{
+  AddSample(PROPAGATION, digest);
+}
+
+void
+PeerTracer::RecordArchived(Ptr<App> app, const RecordDigest& digest, RecordId record)
+{
+  AddSample(CONFIRMATION, digest);
+}
+
+void
+PeerTracer::AddSample(Stage stage, const RecordDigest& digest)
+{
+  if (!IsSampled(digest)) {
+    return;
+  }
+
+  const GenerationTable::Entry* generated = g_generated.Find(digest);
+  if (generated == nullptr) {
+    return; // genesis record, or generated by another rank
+  }
+  // the producer receives nothing, but confirms its own records
+  if (stage != CONFIRMATION && generated->node == m_nodePtr->GetId()) {
+    return;
+  }
+
+  m_latencies[stage].push_back((Simulator::Now() - generated->time).ToDouble(Time::S));
+}
+
+void
+PeerTracer::PeriodicPrinter()
+{
+  for (int stage = 0; stage < N_STAGES; ++stage) {
+    std::vector<double>& latencies = m_latencies[stage];
+    if (latencies.empty()) {
+      continue;
+    }
+
+    // nearest-rank percentiles; each selection only reorders the part above the previous one
+    auto first = latencies.begin();
+    auto percentile = [&latencies, &first] (size_t percent) {
+      auto nth = latencies.begin() + (percent * latencies.size() + 99) / 100 - 1;
+      std::nth_element(first, nth, latencies.end());
+      first = nth;
+      return *nth;
+    };
+    double p50 = percentile(50);
+    double p90 = percentile(90);
+    double p99 = percentile(99);
+    double max = *std::max_element(first, latencies.end());
+
+    m_sink->Write(std::bind(&PeerTracer::PrintLatency, std::placeholders::_1, m_encoder,
+                            Simulator::Now(), m_node, STAGE_NAMES[stage], latencies.size(), p50,
+                            p90, p99, max));
+    latencies.clear();
+  }
+
+  m_printEvent = Simulator::Schedule(m_period, &PeerTracer::PeriodicPrinter, this);
+}
+
+void
+PeerTracer::PrintLatency(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder,
+                         Time time, const std::string& node, const char* type, size_t nSamples,
+                         double p50, double p90, double p99, double max)
+{
+  if (encoder != nullptr) {
+    encoder->AddDouble(time.ToDouble(Time::S))
+      .AddString(node)
+      .AddString(type)
+      .AddInt(nSamples)
+      .AddDouble(p50)
+      .AddDouble(p90)
+      .AddDouble(p99)
+      .AddDouble(max)
+      .EndRow(os);
+    return;
+  }
+
+  os << time.ToDouble(Time::S) << "\t" << node << "\t" << type << "\t" << nSamples << "\t" << p50
+     << "\t" << p90 << "\t" << p99 << "\t" << max << "\n";
+}
+
+} // namespace ndn
+} // namespace ns3
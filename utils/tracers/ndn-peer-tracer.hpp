@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_PEER_TRACER_H
+#define NDN_PEER_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-ledger.hpp"
+
+#include "ndn-trace-sink.hpp"
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/node-container.h>
+
+#include <array>
+#include <tuple>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+class Node;
+
+namespace ndn {
+
+class App;
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Tracer of the DLedger record lifecycle
+ *
+ * Connects to the record lifecycle trace sources of the Peer applications on the node and
+ * periodically writes, for every stage, the percentiles of the time elapsed since the record
+ * was generated:
+ *
+ * - NotifReceived, Fetched, Pending: the NOTIF arrived, the record arrived, the record was
+ *   buffered until its ancestors arrive
+ * - Pushed: the record arrived in its NOTIF (see Peer's MaxPushSize), each saving the fetch
+ *   round trip that Fetched records took
+ * - Propagation: the record was attached to the ledger of the node
+ * - Confirmation: the record was archived by the node, including by its producer
+ *
+ * Records are sampled by their digest, so all nodes sample the same records.  Generation times
+ * are kept only for records generated in this process; with the distributed simulator, records
+ * of the other ranks are not traced.
+ */
+class PeerTracer : public SimpleRefCount<PeerTracer> {
+public:
+  /**
+   * @brief Helper method to install tracers on all simulation nodes
+   *
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
+   * @param averagingPeriod How often data will be written into the trace file (default, every
+   *        second)
+   * @param samplingRate Fraction of the records that are traced (default, all records)
+   */
+  static void
+  InstallAll(const std::string& file, Time averagingPeriod = Seconds(1.0),
+             double samplingRate = 1.0);
+
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes
+   *
+   * @param nodes Nodes on which to install tracer
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
+   * @param averagingPeriod How often data will be written into the trace file (default, every
+   *        second)
+   * @param samplingRate Fraction of the records that are traced (default, all records)
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file, Time averagingPeriod = Seconds(1.0),
+          double samplingRate = 1.0);
+
+  /**
+   * @brief Helper method to install tracers on a specific simulation node
+   *
+   * @param node Node on which to install tracer
+   * @param file File to which traces will be written.  If filename is -, then std::out is used.
+   *             If it ends with .bin, the binary format is used (see BinaryTraceSchema)
+   * @param averagingPeriod How often data will be written into the trace file (default, every
+   *        second)
+   * @param samplingRate Fraction of the records that are traced (default, all records)
+   */
+  static void
+  Install(Ptr<Node> node, const std::string& file, Time averagingPeriod = Seconds(1.0),
+          double samplingRate = 1.0);
+
+  /**
+   * @brief Helper method to install tracers on a specific simulation node
+   *
+   * Several tracers may share the sink; records are formatted on the sink's writer thread
+   * if the sink is asynchronous.
+   */
+  static Ptr<PeerTracer>
+  Install(Ptr<Node> node, shared_ptr<TraceSink> outputStream, Time averagingPeriod = Seconds(1.0),
+          double samplingRate = 1.0);
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   *
+   * Also forgets the generation times of the sampled records.
+   */
+  static void
+  Destroy();
+
+  /**
+   * @brief Trace constructor that attaches to all Peer applications on the node
+   * @param sink  sink to which trace records are written
+   * @param node  pointer to the node
+   */
+  PeerTracer(shared_ptr<TraceSink> sink, Ptr<Node> node);
+
+  /**
+   * @brief Destructor
+   */
+  ~PeerTracer();
+
+  /**
+   * @brief Print head of the trace (e.g., for post-processing)
+   *
+   * @param os reference to output stream
+   */
+  void
+  PrintHeader(std::ostream& os) const;
+
+  void
+  SetAveragingPeriod(const Time& period);
+
+  /**
+   * @brief Set the fraction of the records that are traced, between 0 and 1
+   */
+  void
+  SetSamplingRate(double rate);
+
+private:
+  enum Stage {
+    NOTIF_RECEIVED,
+    FETCHED,
+    PUSHED,
+    PENDING,
+    PROPAGATION,
+    CONFIRMATION,
+    N_STAGES
+  };
+
+  void
+  Connect();
+
+  void
+  CreateEncoder();
+
+  bool
+  IsSampled(const RecordDigest& digest) const;
+
+  void
+  RecordGenerated(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
+  void
+  NotifReceived(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
+  void
+  RecordFetched(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
+  void
+  RecordPushed(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
+  void
+  RecordPending(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
+  void
+  RecordAdmitted(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
+  void
+  RecordArchived(Ptr<App> app, const RecordDigest& digest, RecordId record);
+
+  // adds the time since generation of a sampled record to the stage
+  void
+  AddSample(Stage stage, const RecordDigest& digest);
+
+  void
+  PeriodicPrinter();
+
+  // writes text, or a binary row if encoder is not null
+  static void
+  PrintLatency(std::ostream& os, const shared_ptr<BinaryTraceEncoder>& encoder, Time time,
+               const std::string& node, const char* type, size_t nSamples, double p50, double p90,
+               double p99, double max);
+
+private:
+  std::string m_node;
+  Ptr<Node> m_nodePtr;
+
+  shared_ptr<TraceSink> m_sink;
+  shared_ptr<BinaryTraceEncoder> m_encoder;
+
+  double m_samplingRate;
+  uint64_t m_samplingThreshold; // sampled if the digest hash is below
+
+  // seconds since generation, collected during the current period; cleared keeping the capacity
+  std::array<std::vector<double>, N_STAGES> m_latencies;
+
+  Time m_period;
+  EventId m_printEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_PEER_TRACER_H
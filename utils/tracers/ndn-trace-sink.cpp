@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2016  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-trace-sink.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.TraceSink");
+
+namespace ns3 {
+namespace ndn {
+
+// Live asynchronous sinks, only accessed by the simulation thread.  Never destroyed, as sinks
+// owned by static tracer lists may be destroyed after it at exit.
+static std::vector<TraceSink*>&
+getAsyncSinks()
+{
+  static std::vector<TraceSink*>* sinks = new std::vector<TraceSink*>();
+  return *sinks;
+}
+
+TraceSink::TraceSink(shared_ptr<std::ostream> os, Format format)
+  : m_os(os)
+  , m_format(format)
+  , m_mask(0)
+  , m_head(0)
+  , m_tail(0)
+  , m_isWriterWaiting(false)
+  , m_isStopping(false)
+{
+}
+
+TraceSink::TraceSink(shared_ptr<std::ostream> os, size_t capacity, Format format)
+  : m_os(os)
+  , m_format(format)
+  , m_head(0)
+  , m_tail(0)
+  , m_isWriterWaiting(false)
+  , m_isStopping(false)
+{
+  size_t size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  m_ring.resize(size);
+  m_mask = size - 1;
+
+  m_thread = std::thread(&TraceSink::Run, this);
+
+  getAsyncSinks().push_back(this);
+  Simulator::ScheduleDestroy(&TraceSink::FlushAll);
+}
+
+TraceSink::~TraceSink()
+{
+  if (!IsAsync()) {
+    m_os->flush();
+    return;
+  }
+
+  auto& sinks = getAsyncSinks();
+  sinks.erase(std::find(sinks.begin(), sinks.end(), this));
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopping = true;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+  m_os->flush();
+}
+
+shared_ptr<TraceSink>
+TraceSink::Open(const std::string& file)
+{
+  if (file == "-") {
+    return make_shared<TraceSink>(shared_ptr<std::ostream>(&std::cout, std::bind([]{})));
+  }
+
+  Format format = TEXT;
+  std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+  if (file.size() > 4 && file.compare(file.size() - 4, 4, ".bin") == 0) {
+    format = BINARY;
+    mode |= std::ios_base::binary;
+  }
+
+  shared_ptr<std::ofstream> os(new std::ofstream());
+  os->open(file.c_str(), mode);
+
+  if (!os->is_open()) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+    return nullptr;
+  }
+
+  return make_shared<TraceSink>(os, DEFAULT_CAPACITY, format);
+}
+
+shared_ptr<BinaryTraceEncoder>
+TraceSink::GetBinaryEncoder(const BinaryTraceSchema& schema)
+{
+  if (m_format != BINARY) {
+    return nullptr;
+  }
+
+  if (m_encoder == nullptr) {
+    m_encoder = make_shared<BinaryTraceEncoder>(schema);
+    Write(std::bind(&BinaryTraceEncoder::WriteSchema, m_encoder, std::placeholders::_1));
+  }
+  NS_ASSERT_MSG(m_encoder->GetSchema().table == schema.table,
+                "Tracers of different kinds cannot share a binary sink");
+  return m_encoder;
+}
+
+void
+TraceSink::Write(Writer writer)
+{
+  if (!IsAsync()) {
+    writer(*m_os);
+    return;
+  }
+
+  size_t head = m_head.load(std::memory_order_relaxed);
+  while (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+    // the ring is full, let the writer thread catch up
+    std::this_thread::yield();
+  }
+
+  m_ring[head & m_mask] = std::move(writer);
+  m_head.store(head + 1, std::memory_order_seq_cst);
+
+  if (m_isWriterWaiting.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cv.notify_one();
+  }
+}
+
+void
+TraceSink::WriteText(const std::string& text)
+{
+  Write([text] (std::ostream& os) { os << text; });
+}
+
+void
+TraceSink::Flush()
+{
+  if (!IsAsync()) {
+    m_os->flush();
+    return;
+  }
+
+  Write([] (std::ostream& os) { os.flush(); });
+
+  size_t head = m_head.load(std::memory_order_relaxed);
+  while (m_tail.load(std::memory_order_acquire) != head) {
+    std::this_thread::yield();
+  }
+}
+
+void
+TraceSink::FlushAll()
+{
+  for (TraceSink* sink : getAsyncSinks()) {
+    sink->Flush();
+  }
+}
+
+void
+TraceSink::Run()
+{
+  while (true) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire)) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_isWriterWaiting.store(true, std::memory_order_seq_cst);
+      m_cv.wait(lock, [this, tail] {
+          return m_head.load(std::memory_order_seq_cst) != tail || m_isStopping;
+        });
+      m_isWriterWaiting.store(false, std::memory_order_relaxed);
+
+      if (m_head.load(std::memory_order_acquire) == tail) {
+        return; // stopping, and everything is written
+      }
+      continue;
+    }
+
+    Writer& writer = m_ring[tail & m_mask];
+    writer(*m_os);
+    writer = nullptr;
+    m_tail.store(tail + 1, std::memory_order_release);
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
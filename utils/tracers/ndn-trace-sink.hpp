@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2016  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_TRACE_SINK_H
+#define NDN_TRACE_SINK_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ndn-binary-trace.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Output of tracers
+ *
+ * Tracers pass the sink writers, i.e., functions that format a snapshot of trace values into
+ * the output stream.  A synchronous sink runs every writer immediately.  An asynchronous sink
+ * queues writers in a lock-free single-producer ring buffer, and a background thread runs them,
+ * so that formatting and file I/O do not take simulation time.  The simulation thread is the
+ * only producer; it waits when the ring is full.
+ *
+ * Writers run in the order they are written.  An asynchronous sink is flushed at
+ * Simulator::Destroy and when it is destroyed.
+ *
+ * A binary sink holds the BinaryTraceEncoder of its trace, which tracers use in their writers
+ * instead of formatting text.
+ */
+class TraceSink : boost::noncopyable {
+public:
+  typedef std::function<void(std::ostream&)> Writer;
+
+  enum Format {
+    TEXT,
+    BINARY
+  };
+
+  static const size_t DEFAULT_CAPACITY = 4096;
+
+  /**
+   * @brief Create a synchronous sink
+   */
+  explicit
+  TraceSink(shared_ptr<std::ostream> os, Format format = TEXT);
+
+  /**
+   * @brief Create an asynchronous sink
+   * @param capacity number of writers the ring buffer holds, rounded up to a power of two
+   */
+  TraceSink(shared_ptr<std::ostream> os, size_t capacity, Format format = TEXT);
+
+  ~TraceSink();
+
+  /**
+   * @brief Open the output of file-based tracer installers
+   *
+   * "-" opens a synchronous sink on the standard output, so that trace lines keep their place
+   * among other output.  Any other name opens an asynchronous sink on the truncated file, in the
+   * binary format if the name ends with ".bin".
+   *
+   * @returns nullptr if the file cannot be opened
+   */
+  static shared_ptr<TraceSink>
+  Open(const std::string& file);
+
+  bool
+  IsAsync() const
+  {
+    return m_thread.joinable();
+  }
+
+  bool
+  IsBinary() const
+  {
+    return m_format == BINARY;
+  }
+
+  /**
+   * @brief Get the encoder of a binary sink
+   *
+   * The first call creates the encoder and writes the schema; tracers sharing the sink must
+   * use the same schema.
+   *
+   * @returns nullptr if the sink writes text
+   */
+  shared_ptr<BinaryTraceEncoder>
+  GetBinaryEncoder(const BinaryTraceSchema& schema);
+
+  void
+  Write(Writer writer);
+
+  /**
+   * @brief Write preformatted text, e.g., the header of a trace file
+   */
+  void
+  WriteText(const std::string& text);
+
+  /**
+   * @brief Wait until all writers written so far have run and the stream is flushed
+   */
+  void
+  Flush();
+
+private:
+  void
+  Run();
+
+  // flushes the asynchronous sinks, in creation order
+  static void
+  FlushAll();
+
+private:
+  shared_ptr<std::ostream> m_os;
+  Format m_format;
+  // only dereferenced by writers
+  shared_ptr<BinaryTraceEncoder> m_encoder;
+
+  std::vector<Writer> m_ring;
+  size_t m_mask;
+  // m_head is only advanced by the simulation thread, m_tail only by the writer thread
+  std::atomic<size_t> m_head;
+  std::atomic<size_t> m_tail;
+
+  std::atomic<bool> m_isWriterWaiting;
+  std::atomic<bool> m_isStopping;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::thread m_thread;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_TRACE_SINK_H